@@ -410,7 +410,7 @@ static bool autoConfirm(CampaignType type) {
 }
 
 optional<CampaignSetup> CampaignBuilder::prepareCampaign(function<optional<RetiredGames>(CampaignType)> genRetired,
-    CampaignType type) {
+    CampaignType type, function<void(const Campaign&)> campaignUpdated) {
   Vec2 size(17, 9);
   int numBlocked = 0.6 * size.x * size.y;
   Table<Campaign::SiteInfo> terrain = getTerrain(random, size, numBlocked);
@@ -427,6 +427,8 @@ optional<CampaignSetup> CampaignBuilder::prepareCampaign(function<optional<Retir
       setPlayerPos(campaign, *pos, player.get());
     }
     placeVillains(campaign, getVillainCounts(type, options), retired);
+    if (campaignUpdated)
+      campaignUpdated(campaign);
     while (1) {
       bool updateMap = false;
       campaign.influenceSize = options->getIntValue(OptionId::INFLUENCE_SIZE);
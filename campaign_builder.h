@@ -10,7 +10,9 @@ class TribeId;
 class CampaignBuilder {
   public:
   CampaignBuilder(View*, RandomGen&, Options*, PlayerRole);
-  optional<CampaignSetup> prepareCampaign(function<optional<RetiredGames>(CampaignType)>, CampaignType defaultType);
+  /** campaignUpdated is called every time a new campaign is shown to the player.*/
+  optional<CampaignSetup> prepareCampaign(function<optional<RetiredGames>(CampaignType)>, CampaignType defaultType,
+      function<void(const Campaign&)> campaignUpdated = nullptr);
   static CampaignSetup getEmptyCampaign();
 
   private:
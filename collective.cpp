@@ -69,7 +69,9 @@ Collective::Collective(Private, WLevel l, TribeId t, const optional<CollectiveNa
 
 PCollective Collective::create(WLevel level, TribeId tribe, const optional<CollectiveName>& name) {
   auto ret = makeOwner<Collective>(Private {}, level, tribe, name);
-  ret->subscribeTo(level->getModel());
+  ret->subscribeTo(level->getModel(), {EventId::ALARM, EventId::KILLED, EventId::TORTURED, EventId::SURRENDERED,
+      EventId::TRAP_TRIGGERED, EventId::TRAP_DISARMED, EventId::FURNITURE_DESTROYED, EventId::INVENTORY_CHANGED,
+      EventId::CONQUERED_ENEMY});
   return ret;
 }
 
@@ -398,9 +400,15 @@ void Collective::orderConsumption(WCreature consumer, WCreature who) {
   setTask(consumer, Task::consume(this, who));
 }
 
+void Collective::autoAssignEquipment() {
+  vector<WConstCreature> creatures;
+  for (WCreature c : getCreatures())
+    if (usesEquipment(c) && !hasTrait(c, MinionTrait::NO_AUTO_EQUIPMENT))
+      creatures.push_back(c);
+  minionEquipment->autoAssign(creatures, getAllItems(ItemIndex::MINION_EQUIPMENT, false));
+}
+
 PTask Collective::getEquipmentTask(WCreature c) {
-  if (!hasTrait(c, MinionTrait::NO_AUTO_EQUIPMENT) && Random.roll(40))
-    minionEquipment->autoAssign(c, getAllItems(ItemIndex::MINION_EQUIPMENT, false));
   vector<PTask> tasks;
   for (WItem it : c->getEquipment().getItems())
     if (!c->getEquipment().isEquipped(it) && c->getEquipment().canEquip(it))
@@ -620,17 +628,11 @@ void Collective::tick() {
   if (config->getConstructions())
     updateConstructions();
   if (config->getFetchItems() && Random.roll(5))
-    for (const ItemFetchInfo& elem : CollectiveConfig::getFetchInfo()) {
-      for (Position pos : territory->getAll())
-        fetchItems(pos, elem);
-      for (Position pos : zones->getPositions(ZoneId::FETCH_ITEMS))
-        fetchItems(pos, elem);
-      for (Position pos : zones->getPositions(ZoneId::PERMANENT_FETCH_ITEMS))
-        fetchItems(pos, elem);
-    }
+    updateItemFetching();
   if (config->getManageEquipment() && Random.roll(40)) {
     minionEquipment->updateOwners(getCreatures());
     minionEquipment->updateItems(getAllItems(ItemIndex::MINION_EQUIPMENT, true));
+    autoAssignEquipment();
   }
   workshops->scheduleItems(this);
 }
@@ -780,8 +782,12 @@ void Collective::onEvent(const GameEvent& event) {
       auto info = event.get<EventInfo::FurnitureEvent>();
       constructions->onFurnitureDestroyed(info.position, info.layer);
       tileEfficiency->update(info.position);
+      setFetchDirty(info.position);
       break;
     }
+    case EventId::INVENTORY_CHANGED:
+      setFetchDirty(event.get<Position>());
+      break;
     case EventId::CONQUERED_ENEMY: {
       WCollective col = event.get<WCollective>();
       if (col->getVillainType() == VillainType::MAIN || col->getVillainType() == VillainType::LESSER) {
@@ -859,6 +865,7 @@ bool Collective::canClaimSquare(Position pos) const {
 void Collective::claimSquare(Position pos) {
   //CHECK(canClaimSquare(pos));
   territory->insert(pos);
+  setFetchDirty(pos);
   for (auto furniture : pos.modFurniture())
     if (!furniture->isWall()) {
       if (!constructions->containsFurniture(pos, furniture->getLayer()))
@@ -949,9 +956,9 @@ void Collective::returnResource(const CostInfo& amount) {
     return;
   CHECK(amount.value > 0);
   if (auto storageType = config->getResourceInfo(amount.id).storageDestination) {
-    const set<Position>& destination = storageType(this);
+    const PositionSet& destination = storageType(this);
     if (!destination.empty()) {
-      Random.choose(destination).dropItems(ItemFactory::fromId(
+      Random.choose(asVector<Position>(destination)).dropItems(ItemFactory::fromId(
             config->getResourceInfo(amount.id).itemId, amount.value));
       return;
     }
@@ -1021,7 +1028,7 @@ int Collective::getNumItems(ItemIndex index, bool includeMinions) const {
   return ret;
 }
 
-optional<set<Position>> Collective::getStorageFor(const WItem item) const {
+optional<const PositionSet&> Collective::getStorageFor(const WItem item) const {
   for (auto& info : config->getFetchInfo())
     if (getIndexPredicate(info.index)(item))
       return info.destinationFun(this);
@@ -1080,6 +1087,7 @@ void Collective::removeFurniture(Position pos, FurnitureLayer layer) {
   if (f->hasTask())
     returnResource(taskMap->removeTask(f->getTask()));
   constructions->removeFurniture(pos, layer);
+  setFetchDirty(pos);
 }
 
 void Collective::destroySquare(Position pos, FurnitureLayer layer) {
@@ -1092,6 +1100,7 @@ void Collective::destroySquare(Position pos, FurnitureLayer layer) {
     removeFurniture(pos, layer);
   if (layer != FurnitureLayer::FLOOR) {
     zones->eraseZones(pos);
+    setFetchDirty(pos);
     if (constructions->containsTrap(pos))
       removeTrap(pos);
   }
@@ -1189,10 +1198,11 @@ void Collective::onDestructed(Position pos, FurnitureType type, const DestroyAct
   tileEfficiency->update(pos);
   switch (action.getType()) {
     case DestroyAction::Type::CUT:
-      zones->setZone(pos, ZoneId::FETCH_ITEMS);
+      setZone(pos, ZoneId::FETCH_ITEMS);
       break;
     case DestroyAction::Type::DIG:
       territory->insert(pos);
+      setFetchDirty(pos);
       break;
     default:
       break;
@@ -1294,23 +1304,68 @@ bool Collective::isDelayed(Position pos) {
   return delayedPos.count(pos) && delayedPos.at(pos) > getLocalTime();
 }
 
-void Collective::fetchItems(Position pos, const ItemFetchInfo& elem) {
-  if (isDelayed(pos) || !pos.canEnterEmpty(MovementTrait::WALK) || elem.destinationFun(this).count(pos))
-    return;
-  vector<WItem> equipment = pos.getItems(elem.index).filter(
+bool Collective::isFetchPosition(Position pos) const {
+  return territory->contains(pos) || zones->isZone(pos, ZoneId::FETCH_ITEMS) ||
+      zones->isZone(pos, ZoneId::PERMANENT_FETCH_ITEMS);
+}
+
+void Collective::setFetchDirty(Position pos) {
+  if (!allFetchPositionsDirty && isFetchPosition(pos))
+    dirtyFetchPositions.insert(pos);
+}
+
+void Collective::updateItemFetching() {
+  if (allFetchPositionsDirty) {
+    for (Position pos : territory->getAll())
+      dirtyFetchPositions.insert(pos);
+    for (Position pos : zones->getPositions(ZoneId::FETCH_ITEMS))
+      dirtyFetchPositions.insert(pos);
+    for (Position pos : zones->getPositions(ZoneId::PERMANENT_FETCH_ITEMS))
+      dirtyFetchPositions.insert(pos);
+    allFetchPositionsDirty = false;
+  }
+  for (Position pos : copyOf(dirtyFetchPositions)) {
+    bool done = true;
+    if (isFetchPosition(pos))
+      for (const ItemFetchInfo& elem : CollectiveConfig::getFetchInfo())
+        if (!fetchItems(pos, elem))
+          done = false;
+    if (done)
+      dirtyFetchPositions.erase(pos);
+  }
+}
+
+// Returns false if the position needs to be checked again on the next pass, because something
+// that isn't tracked by inventory changes (task delays, item marks, missing storage) prevented fetching.
+bool Collective::fetchItems(Position pos, const ItemFetchInfo& elem) {
+  if (elem.destinationFun(this).count(pos))
+    return true;
+  const vector<WItem>& items = pos.getItems(elem.index);
+  if (items.empty())
+    return true;
+  if (isDelayed(pos) || !pos.canEnterEmpty(MovementTrait::WALK))
+    return false;
+  vector<WItem> equipment = items.filter(
       [this, &elem] (const WItem item) { return elem.predicate(this, item); });
   if (!equipment.empty()) {
-    const set<Position>& destination = elem.destinationFun(this);
+    const PositionSet& destination = elem.destinationFun(this);
     if (!destination.empty()) {
       warnings->setWarning(elem.warning, false);
       if (elem.oneAtATime)
         equipment = {equipment[0]};
-      taskMap->addTask(Task::bringItem(this, pos, equipment, destination), pos);
+      taskMap->addTask(Task::bringItem(this, pos, equipment, asVector<Position>(destination)), pos);
       for (WItem it : equipment)
         markItem(it);
-    } else
+    } else {
       warnings->setWarning(elem.warning, true);
+      return false;
+    }
   }
+  // Marked items may get unmarked without leaving the tile if the task fails.
+  for (WItem it : items)
+    if (isItemMarked(it))
+      return false;
+  return true;
 }
 
 void Collective::handleSurprise(Position pos) {
@@ -1564,6 +1619,16 @@ static optional<Vec2> getAdjacentWall(Position pos) {
   return none;
 }
 
+void Collective::setZone(Position pos, ZoneId id) {
+  zones->setZone(pos, id);
+  setFetchDirty(pos);
+}
+
+void Collective::eraseZone(Position pos, ZoneId id) {
+  zones->eraseZone(pos, id);
+  setFetchDirty(pos);
+}
+
 Zones& Collective::getZones() {
   return *zones;
 }
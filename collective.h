@@ -35,6 +35,7 @@ class TaskMap;
 class KnownTiles;
 class CollectiveTeams;
 class ConstructionMap;
+class PositionSet;
 class Technology;
 class CollectiveConfig;
 class CostInfo;
@@ -44,6 +45,7 @@ struct CollectiveName;
 class Workshops;
 class TileEfficiency;
 class Zones;
+enum class ZoneId;
 struct ItemFetchInfo;
 class CollectiveWarnings;
 class Immigration;
@@ -127,6 +129,9 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
 
   const ConstructionMap& getConstructions() const;
 
+  void setZone(Position, ZoneId);
+  void eraseZone(Position, ZoneId);
+
   void setMinionTask(WConstCreature c, MinionTask task);
   optional<MinionTask> getMinionTask(WConstCreature) const;
   bool isMinionTaskPossible(WCreature c, MinionTask task);
@@ -195,7 +200,7 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   void updateResourceProduction();
   bool isItemMarked(const WItem) const;
   int getNumItems(ItemIndex, bool includeMinions = true) const;
-  optional<set<Position>> getStorageFor(const WItem) const;
+  optional<const PositionSet&> getStorageFor(const WItem) const;
 
   void addKnownVillain(WConstCollective);
   bool isKnownVillain(WConstCollective) const;
@@ -229,7 +234,10 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   void onMinionKilled(WCreature victim, WCreature killer);
   void onKilledSomeone(WCreature victim, WCreature killer);
 
-  void fetchItems(Position, const ItemFetchInfo&);
+  bool fetchItems(Position, const ItemFetchInfo&);
+  void updateItemFetching();
+  bool isFetchPosition(Position) const;
+  void setFetchDirty(Position);
 
   void addMoraleForKill(WConstCreature killer, WConstCreature victim);
   void decreaseMoraleForKill(WConstCreature killer, WConstCreature victim);
@@ -261,6 +269,7 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   optional<Position> getTileToExplore(WConstCreature, MinionTask) const;
   PTask getStandardTask(WCreature c);
   PTask getEquipmentTask(WCreature c);
+  void autoAssignEquipment();
   void considerHealingTask(WCreature c);
   bool isTaskGood(WConstCreature, MinionTask, bool ignoreTaskLock = false) const;
   void setRandomTask(WConstCreature);
@@ -309,6 +318,9 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   optional<EnemyId> SERIAL(enemyId);
   unique_ptr<Workshops> SERIAL(workshops);
   HeapAllocated<Zones> SERIAL(zones);
+  // Tiles whose items need to be checked for fetching. Not serialized, the whole area is rescanned after loading.
+  set<Position> dirtyFetchPositions;
+  bool allFetchPositionsDirty = true;
   HeapAllocated<TileEfficiency> SERIAL(tileEfficiency);
   HeapAllocated<CollectiveWarnings> SERIAL(warnings);
   PImmigration SERIAL(immigration);
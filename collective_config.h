@@ -26,6 +26,7 @@ enum class ItemClass;
 class Game;
 class Workshops;
 class ImmigrantInfo;
+class PositionSet;
 
 struct PopulationIncrease {
   FurnitureType SERIAL(type);
@@ -51,7 +52,7 @@ struct DormInfo {
   optional<CollectiveWarning> warning;
 };
 
-typedef function<const set<Position>&(WConstCollective)> StorageDestinationFun;
+typedef function<const PositionSet&(WConstCollective)> StorageDestinationFun;
 
 struct ResourceInfo {
   StorageDestinationFun storageDestination;
@@ -124,7 +124,7 @@ int ConstructionMap::getTotalCount(FurnitureType type) const {
   return unbuiltCounts[type] + getBuiltCount(type);
 }
 
-const set<Position>& ConstructionMap::getBuiltPositions(FurnitureType type) const {
+const PositionSet& ConstructionMap::getBuiltPositions(FurnitureType type) const {
   return furniturePositions[type];
 }
 
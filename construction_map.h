@@ -4,6 +4,7 @@
 #include "util.h"
 #include "unique_entity.h"
 #include "position.h"
+#include "position_set.h"
 #include "furniture_type.h"
 #include "furniture_layer.h"
 #include "resource_id.h"
@@ -60,7 +61,7 @@ class ConstructionMap {
   bool containsFurniture(Position, FurnitureLayer) const;
   int getBuiltCount(FurnitureType) const;
   int getTotalCount(FurnitureType) const;
-  const set<Position>& getBuiltPositions(FurnitureType) const;
+  const PositionSet& getBuiltPositions(FurnitureType) const;
   void onConstructed(Position, FurnitureType);
 
   const TrapInfo& getTrap(Position) const;
@@ -80,7 +81,7 @@ class ConstructionMap {
   private:
   optional<FurnitureInfo&> modFurniture(Position, FurnitureLayer);
   EnumMap<FurnitureLayer, map<Position, FurnitureInfo>> SERIAL(furniture);
-  EnumMap<FurnitureType, set<Position>> SERIAL(furniturePositions);
+  EnumMap<FurnitureType, PositionSet> SERIAL(furniturePositions);
   EnumMap<FurnitureType, int> SERIAL(unbuiltCounts);
   vector<pair<Position, FurnitureLayer>> SERIAL(allFurniture);
   map<Position, TrapInfo> SERIAL(traps);
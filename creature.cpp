@@ -869,9 +869,8 @@ void Creature::tick() {
       equipment->removeItem(item, this);
   }
   double globalTime = getGlobalTime();
-  for (LastingEffect effect : ENUM_ALL(LastingEffect))
-    if (attributes->considerTimeout(effect, globalTime))
-      LastingEffects::onTimedOut(this, effect, true);
+  for (LastingEffect effect : attributes->considerTimeouts(globalTime))
+    LastingEffects::onTimedOut(this, effect, true);
   if (isAffected(LastingEffect::POISON))
     if (getBody().affectByPoison(this, 0.015)) {
       dieWithAttacker(lastAttacker);
@@ -1040,6 +1039,8 @@ bool Creature::takeDamage(const Attack& attack) {
     INFO << getName().the() << " attacked by " << attacker->getName().the()
       << " damage " << attack.getStrength() << " defense " << defense;
     lastAttacker = attack.getAttacker();
+    if (WModel model = position.getModel())
+      model->wakeUpCreature(this);
   }
   if (auto sound = attributes->getAttackSound(attack.getType(), attack.getStrength() > defense))
     addSound(*sound);
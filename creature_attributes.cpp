@@ -227,11 +227,25 @@ bool CreatureAttributes::considerTimeout(LastingEffect effect, double globalTime
   return false;
 }
   
+EnumSet<LastingEffect> CreatureAttributes::considerTimeouts(double globalTime) {
+  EnumSet<LastingEffect> ret;
+  if (nextTimeout < globalTime) {
+    nextTimeout = std::numeric_limits<double>::max();
+    for (LastingEffect effect : ENUM_ALL(LastingEffect))
+      if (considerTimeout(effect, globalTime))
+        ret.insert(effect);
+      else if (lastingEffects[effect] > 0)
+        nextTimeout = min(nextTimeout, lastingEffects[effect]);
+  }
+  return ret;
+}
+
 bool CreatureAttributes::considerAffecting(LastingEffect effect, double globalTime, double timeout) {
   bool ret = false;
   if (lastingEffects[effect] < globalTime + timeout) {
     ret = !isAffected(effect, globalTime);
     lastingEffects[effect] = globalTime + timeout;
+    nextTimeout = min(nextTimeout, lastingEffects[effect]);
   }
   return ret;
 }
@@ -363,6 +377,7 @@ bool CreatureAttributes::isAffectedPermanently(LastingEffect effect) const {
 void CreatureAttributes::shortenEffect(LastingEffect effect, double time) {
   CHECK(lastingEffects[effect] >= time);
   lastingEffects[effect] -= time;
+  nextTimeout = min(nextTimeout, lastingEffects[effect]);
 }
 
 void CreatureAttributes::clearLastingEffect(LastingEffect effect) {
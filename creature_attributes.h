@@ -89,6 +89,9 @@ class CreatureAttributes {
   void addPermanentEffect(LastingEffect);
   void removePermanentEffect(LastingEffect);
   bool considerTimeout(LastingEffect, double globalTime);
+  /** Times out all expired effects and returns the ones that no longer affect the creature. Does nothing
+      until the earliest timeout is reached.*/
+  EnumSet<LastingEffect> considerTimeouts(double globalTime);
   bool considerAffecting(LastingEffect, double globalTime, double timeout);
   bool canCarryAnything() const;
   int getBarehandedDamage() const;
@@ -133,6 +136,9 @@ class CreatureAttributes {
   HeapAllocated<SpellMap> SERIAL(spells);
   EnumMap<LastingEffect, int> SERIAL(permanentEffects);
   EnumMap<LastingEffect, double> SERIAL(lastingEffects);
+  // Lower bound on the earliest timeout in lastingEffects. Not saved, so the first tick after loading
+  // recomputes it.
+  double nextTimeout = 0;
   MinionTaskMap SERIAL(minionTasks);
   EnumMap<ExperienceType, EnumMap<AttrType, double>> SERIAL(attrIncrease);
   bool SERIAL(noAttackSound) = false;
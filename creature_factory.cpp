@@ -402,7 +402,8 @@ class ShopkeeperController : public Monster, public EventListener<ShopkeeperCont
   virtual void makeMove() override {
     if (firstMove) {
       myLevel = getCreature()->getLevel();
-      subscribeTo(getCreature()->getPosition().getModel());
+      subscribeTo(getCreature()->getPosition().getModel(), {EventId::ITEMS_APPEARED, EventId::PICKED_UP,
+          EventId::DROPPED});
       for (Position v : getAllShopPositions()) {
         for (WItem item : v.getItems())
           item->setShopkeeper(getCreature());
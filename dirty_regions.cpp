@@ -0,0 +1,46 @@
+#include "stdafx.h"
+#include "dirty_regions.h"
+
+DirtyRegions::DirtyRegions(Rectangle b, int size) : bounds(b), blockSize(size),
+    blocks((b.width() + size - 1) / size, (b.height() + size - 1) / size, false) {
+}
+
+void DirtyRegions::add(Vec2 pos) {
+  CHECK(pos.inRectangle(bounds)) << pos << " " << bounds;
+  blocks[(pos - bounds.topLeft()) / blockSize] = true;
+  empty = false;
+}
+
+void DirtyRegions::addAll() {
+  for (Vec2 v : blocks.getBounds())
+    blocks[v] = true;
+  empty = false;
+}
+
+bool DirtyRegions::isEmpty() const {
+  return empty;
+}
+
+vector<Rectangle> DirtyRegions::pop() {
+  vector<Rectangle> ret;
+  if (empty)
+    return ret;
+  for (int y : blocks.getBounds().getYRange()) {
+    optional<int> runStart;
+    for (int x : Range(blocks.getBounds().right() + 1)) {
+      bool dirty = x < blocks.getBounds().right() && blocks[Vec2(x, y)];
+      if (dirty && !runStart)
+        runStart = x;
+      if (!dirty && runStart) {
+        Vec2 topLeft = bounds.topLeft() + Vec2(*runStart, y) * blockSize;
+        Vec2 bottomRight = bounds.topLeft() + Vec2(x, y + 1) * blockSize;
+        ret.push_back(Rectangle(topLeft, Vec2(min(bounds.right(), bottomRight.x), min(bounds.bottom(), bottomRight.y))));
+        runStart = none;
+      }
+      if (dirty)
+        blocks[Vec2(x, y)] = false;
+    }
+  }
+  empty = true;
+  return ret;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "util.h"
+
+/** Keeps track of which parts of an image have changed since they were last uploaded. The image is
+    split into square blocks, and dirty blocks next to each other in a row are merged into one rectangle.*/
+class DirtyRegions {
+  public:
+  DirtyRegions(Rectangle bounds, int blockSize);
+
+  void add(Vec2);
+  void addAll();
+  bool isEmpty() const;
+
+  /** Returns the changed rectangles and marks everything clean.*/
+  vector<Rectangle> pop();
+
+  private:
+  Rectangle bounds;
+  int blockSize;
+  Table<bool> blocks;
+  bool empty = true;
+};
@@ -2,20 +2,73 @@
 #include "event_generator.h"
 #include "event_listener.h"
 
+EventGenerator::EventGenerator() {
+}
+
+EventGenerator::~EventGenerator() {
+}
+
+void EventGenerator::updateIndex() {
+  if (!indexValid) {
+    indexValid = true;
+    for (auto id : ENUM_ALL(EventId))
+      index[id] = Subscribers();
+    for (auto& l : listeners)
+      for (auto event : l.second->getEvents()) {
+        auto& subscribers = index[event];
+        (l.second->isBatched() ? subscribers.batched : subscribers.immediate).push_back(l.first);
+      }
+  }
+}
+
+void EventGenerator::deliver(const GameEvent& e, const vector<SubscriberId>& ids) {
+  // Listeners may be added or removed by the handlers, so they are looked up one by one.
+  for (auto id : ids)
+    if (auto l = getReferenceMaybe(listeners, id))
+      (*l)->onEvent(e);
+}
+
 void EventGenerator::addEvent(const GameEvent& e) {
-  for (auto& l : listeners)
-    l.second->onEvent(e);
+  updateIndex();
+  auto& subscribers = index[e.getId()];
+  if (!subscribers.immediate.empty())
+    deliver(e, vector<SubscriberId>(subscribers.immediate));
+  if (!subscribers.batched.empty()) {
+    if (inBatch)
+      batch.push_back(e);
+    else
+      deliver(e, vector<SubscriberId>(subscribers.batched));
+  }
+}
+
+void EventGenerator::startBatch() {
+  CHECK(!inBatch);
+  inBatch = true;
+}
+
+void EventGenerator::flushBatch() {
+  CHECK(inBatch);
+  inBatch = false;
+  auto events = std::move(batch);
+  batch.clear();
+  for (auto& e : events) {
+    updateIndex();
+    deliver(e, vector<SubscriberId>(index[e.getId()].batched));
+  }
 }
 
 void EventGenerator::removeListener(EventGenerator::SubscriberId id) {
   // Seems to crash when an exception is thrown during game loading and the half-read game needs to be destructed.
   //CHECK(listeners.count(id));
   listeners.erase(id);
+  indexValid = false;
 }
 
 template <class Archive>
 void EventGenerator::serialize(Archive& ar, const unsigned int) {
   ar & SUBCLASS(OwnedObject<EventGenerator>);
   ar(listeners);
+  if (Archive::is_loading::value)
+    indexValid = false;
 }
 SERIALIZABLE(EventGenerator);
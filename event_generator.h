@@ -4,20 +4,59 @@
 
 class GameEvent;
 
+RICH_ENUM(EventId,
+  MOVED,
+  KILLED,
+  PICKED_UP,
+  DROPPED,
+  ITEMS_APPEARED,
+  ITEMS_THROWN,
+  EXPLOSION,
+  CONQUERED_ENEMY,
+  WON_GAME,
+  TECHBOOK_READ,
+  ALARM,
+  TORTURED,
+  SURRENDERED,
+  TRAP_TRIGGERED,
+  TRAP_DISARMED,
+  FURNITURE_DESTROYED,
+  EQUIPED,
+  CREATURE_EVENT,
+  POSITION_DISCOVERED,
+  INVENTORY_CHANGED
+);
+
 class ListenerBase {
   public:
+  ListenerBase(EnumSet<EventId> e, bool b) : events(e), batched(b) {}
+  SERIALIZATION_CONSTRUCTOR(ListenerBase)
   virtual void onEvent(const GameEvent&) = 0;
   virtual ~ListenerBase() {}
 
+  const EnumSet<EventId>& getEvents() const {
+    return events;
+  }
+
+  bool isBatched() const {
+    return batched;
+  }
+
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version) {
+    ar(events, batched);
   }
+
+  private:
+  EnumSet<EventId> SERIAL(events);
+  bool SERIAL(batched) = false;
 };
 
 template<typename T>
 class ListenerTemplate : public ListenerBase {
   public:
-  ListenerTemplate(WeakPointer<T> p) : ptr(p) {}
+  ListenerTemplate(WeakPointer<T> p, EnumSet<EventId> events, bool batched)
+      : ListenerBase(events, batched), ptr(p) {}
   SERIALIZATION_CONSTRUCTOR(ListenerTemplate)
 
   virtual void onEvent(const GameEvent& e) override {
@@ -34,27 +73,45 @@ class ListenerTemplate : public ListenerBase {
   WeakPointer<T> SERIAL(ptr);
 };
 
+/** Delivers each event only to the listeners subscribed to its EventId. Listeners marked as batched
+    don't receive events generated between startBatch() and flushBatch() until the batch is flushed.*/
 class EventGenerator : public OwnedObject<EventGenerator> {
   public:
   using SubscriberId = long long;
 
+  EventGenerator();
+  ~EventGenerator();
+
   void addEvent(const GameEvent&);
 
   template <typename T>
-  SubscriberId addListener(WeakPointer<T> t) {
+  SubscriberId addListener(WeakPointer<T> t, EnumSet<EventId> events, bool batched) {
     auto id = Random.getLL();
-    listeners.emplace(id, unique_ptr<ListenerBase>(new ListenerTemplate<T>(t)));
+    listeners.emplace(id, unique_ptr<ListenerBase>(new ListenerTemplate<T>(t, events, batched)));
+    indexValid = false;
     return id;
   }
 
   void removeListener(SubscriberId id);
 
+  void startBatch();
+  void flushBatch();
+
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version);
 
   private:
+  void updateIndex();
+  void deliver(const GameEvent&, const vector<SubscriberId>&);
   map<SubscriberId, unique_ptr<ListenerBase>> SERIAL(listeners);
+  struct Subscribers {
+    vector<SubscriberId> immediate;
+    vector<SubscriberId> batched;
+  };
+  EnumMap<EventId, Subscribers> index;
+  bool indexValid = false;
+  vector<GameEvent> batch;
+  bool inBatch = false;
 };
 
 
-
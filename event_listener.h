@@ -10,28 +10,6 @@ class Model;
 class Technology;
 class Collective;
 
-enum class EventId {
-  MOVED,
-  KILLED,
-  PICKED_UP,
-  DROPPED,
-  ITEMS_APPEARED,
-  ITEMS_THROWN,
-  EXPLOSION,
-  CONQUERED_ENEMY,
-  WON_GAME,
-  TECHBOOK_READ,
-  ALARM,
-  TORTURED,
-  SURRENDERED,
-  TRAP_TRIGGERED,
-  TRAP_DISARMED,
-  FURNITURE_DESTROYED,
-  EQUIPED,
-  CREATURE_EVENT,
-  POSITION_DISCOVERED
-};
-
 namespace EventInfo {
 
 struct Attacked {
@@ -77,7 +55,7 @@ class GameEvent : public EnumVariant<EventId, TYPES(WCreature, Position, Technol
     EventInfo::ItemsThrown, EventInfo::TrapDisarmed, EventInfo::FurnitureEvent),
     ASSIGN(WCreature, EventId::MOVED),
     ASSIGN(Position, EventId::EXPLOSION, EventId::ALARM, EventId::TRAP_TRIGGERED,
-        EventId::POSITION_DISCOVERED),
+        EventId::POSITION_DISCOVERED, EventId::INVENTORY_CHANGED),
     ASSIGN(Technology*, EventId::TECHBOOK_READ),
     ASSIGN(WCollective, EventId::CONQUERED_ENEMY),
     ASSIGN(EventInfo::CreatureEvent, EventId::CREATURE_EVENT),
@@ -98,10 +76,11 @@ class EventListener {
   EventListener(const EventListener&) = delete;
   EventListener(EventListener&&) = delete;
 
-  void subscribeTo(WModel m) {
+  /** Batched listeners receive the events generated during a creature's move after the move is finished.*/
+  void subscribeTo(WModel m, EnumSet<EventId> events, bool batched = false) {
     CHECK(!generator && !id);
     generator = m->eventGenerator.get();
-    id = generator->addListener(WeakPointer<T>(static_cast<T*>(this)));
+    id = generator->addListener(WeakPointer<T>(static_cast<T*>(this)), events, batched);
   }
 
   void unsubscribe() {
@@ -105,6 +105,21 @@ const vector<Vec2>& FieldOfView::getVisibleTiles(Vec2 from) {
   return visibility[from]->getVisibleTiles();
 }
 
+void FieldOfView::precompute(const vector<Vec2>& positions) {
+  // A Visibility only reads the level and each one goes to its own slot, so the threads don't need to sync.
+  std::atomic<int> next(0);
+  vector<thread> threads;
+  for (int i : Range(min<int>(positions.size(), max(1, (int) thread::hardware_concurrency()))))
+    threads.emplace_back([&] {
+      for (int index = next++; index < positions.size(); index = next++) {
+        Vec2 pos = positions[index];
+        if (!visibility[pos])
+          visibility[pos].reset(new Visibility(level, vision, pos.x, pos.y));
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+}
 
 void FieldOfView::Visibility::calculate(int left, int right, int up, int h, int x1, int y1, int x2, int y2,
     function<bool (int, int)> isBlocking, function<void (int, int)> setVisible){
@@ -26,6 +26,9 @@ class FieldOfView {
   bool canSee(Vec2 from, Vec2 to);
   const vector<Vec2>& getVisibleTiles(Vec2 from);
   void squareChanged(Vec2 pos);
+  /** Computes the visible tiles from the given positions on worker threads, so that later queries don't
+      have to. The positions must be unique.*/
+  void precompute(const vector<Vec2>& positions);
 
   SERIALIZATION_DECL(FieldOfView);
 
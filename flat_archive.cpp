@@ -0,0 +1,128 @@
+#include "stdafx.h"
+#include "flat_archive.h"
+
+static const std::size_t bufferSize = 1 << 16;
+static const int minPointerTableBits = 12;
+
+FlatOutputArchive::FlatOutputArchive(std::ostream& s)
+    : cereal::OutputArchive<FlatOutputArchive, cereal::AllowEmptyClassElision>(this), stream(s), buffer(bufferSize) {
+}
+
+FlatOutputArchive::~FlatOutputArchive() CEREAL_NOEXCEPT {
+  // Errors can't be reported from here, the owner is expected to call flush() first.
+  writeBuffer();
+}
+
+bool FlatOutputArchive::writeBuffer() {
+  std::size_t written = used > 0 ? static_cast<std::size_t>(stream.rdbuf()->sputn(buffer.data(), used)) : 0;
+  bool ok = written == used;
+  used = 0;
+  return ok;
+}
+
+void FlatOutputArchive::flush() {
+  auto size = used;
+  if (!writeBuffer())
+    throw cereal::Exception("Failed to write " + std::to_string(size) + " bytes to output stream!");
+}
+
+void FlatOutputArchive::saveBinarySlow(const void* data, std::size_t size) {
+  flush();
+  if (size >= buffer.size()) {
+    auto written = static_cast<std::size_t>(stream.rdbuf()->sputn(reinterpret_cast<const char*>(data), size));
+    if (written != size)
+      throw cereal::Exception("Failed to write " + std::to_string(size) + " bytes to output stream! Wrote "
+          + std::to_string(written));
+  } else {
+    memcpy(buffer.data(), data, size);
+    used = size;
+  }
+}
+
+std::size_t FlatOutputArchive::getSlot(const void* addr) const {
+  // Fibonacci hashing, the low bits of an address are mostly zero.
+  return std::size_t((std::uint64_t(reinterpret_cast<std::uintptr_t>(addr)) * 0x9E3779B97F4A7C15ull)
+      >> (64 - pointerTableBits));
+}
+
+void FlatOutputArchive::growPointerTable() {
+  auto oldTable = std::move(pointerTable);
+  pointerTableBits = std::max(minPointerTableBits, pointerTableBits + 1);
+  pointerTable = std::vector<PointerEntry>(std::size_t(1) << pointerTableBits, PointerEntry{nullptr, 0});
+  std::size_t mask = pointerTable.size() - 1;
+  for (auto& entry : oldTable)
+    if (entry.addr) {
+      auto slot = getSlot(entry.addr);
+      while (pointerTable[slot].addr)
+        slot = (slot + 1) & mask;
+      pointerTable[slot] = entry;
+    }
+}
+
+std::uint32_t FlatOutputArchive::registerSharedPointer(const void* addr) {
+  if (!addr)
+    return 0;
+  if (2 * (numPointers + 1) > pointerTable.size())
+    growPointerTable();
+  std::size_t mask = pointerTable.size() - 1;
+  for (auto slot = getSlot(addr);; slot = (slot + 1) & mask) {
+    auto& entry = pointerTable[slot];
+    if (entry.addr == addr)
+      return entry.id;
+    if (!entry.addr) {
+      entry = PointerEntry{addr, ++numPointers};
+      return entry.id | cereal::detail::msb_32bit;
+    }
+  }
+}
+
+FlatInputArchive::FlatInputArchive(std::istream& s)
+    : cereal::InputArchive<FlatInputArchive, cereal::AllowEmptyClassElision>(this), stream(s), buffer(bufferSize),
+      pointers(1), polymorphicNames(1) {
+}
+
+void FlatInputArchive::loadBinarySlow(void* data, std::size_t size) {
+  auto out = reinterpret_cast<char*>(data);
+  std::size_t done = bufferEnd - bufferPos;
+  memcpy(out, buffer.data() + bufferPos, done);
+  bufferPos = bufferEnd = 0;
+  if (size - done >= buffer.size())
+    done += stream.rdbuf()->sgetn(out + done, size - done);
+  else {
+    bufferEnd = stream.rdbuf()->sgetn(buffer.data(), buffer.size());
+    auto num = std::min(bufferEnd, size - done);
+    memcpy(out + done, buffer.data(), num);
+    bufferPos = num;
+    done += num;
+  }
+  if (done != size)
+    throw cereal::Exception("Failed to read " + std::to_string(size) + " bytes from input stream! Read "
+        + std::to_string(done));
+}
+
+std::shared_ptr<void> FlatInputArchive::getSharedPointer(std::uint32_t id) {
+  if (id >= pointers.size() || (id > 0 && !pointers[id]))
+    throw cereal::Exception("Error while trying to deserialize a smart pointer. Could not find id " + std::to_string(id));
+  return pointers[id];
+}
+
+void FlatInputArchive::registerSharedPointer(std::uint32_t id, std::shared_ptr<void> ptr) {
+  id &= ~cereal::detail::msb_32bit;
+  if (id >= pointers.size())
+    pointers.resize(std::max<std::size_t>(id + 1, 2 * pointers.size()));
+  pointers[id] = std::move(ptr);
+}
+
+std::string FlatInputArchive::getPolymorphicName(std::uint32_t id) {
+  if (id >= polymorphicNames.size() || polymorphicNames[id].empty())
+    throw cereal::Exception("Error while trying to deserialize a polymorphic pointer. Could not find type id "
+        + std::to_string(id));
+  return polymorphicNames[id];
+}
+
+void FlatInputArchive::registerPolymorphicName(std::uint32_t id, const std::string& name) {
+  id &= ~cereal::detail::msb_32bit;
+  if (id >= polymorphicNames.size())
+    polymorphicNames.resize(id + 1);
+  polymorphicNames[id] = name;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cereal/cereal.hpp>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+/** Binary archive that keeps the object tables flat. Shared pointers get dense ids in the order they
+    are first saved, so the loading side keeps them in a vector indexed by id, and the saving side maps
+    addresses to ids with an open addressing table instead of a node based hash map. Reads and writes go
+    through a buffer, so a single number doesn't cost a virtual call on the stream.*/
+class FlatOutputArchive : public cereal::OutputArchive<FlatOutputArchive, cereal::AllowEmptyClassElision> {
+  public:
+  FlatOutputArchive(std::ostream&);
+  ~FlatOutputArchive() CEREAL_NOEXCEPT;
+
+  void saveBinary(const void* data, std::size_t size) {
+    if (size <= buffer.size() - used) {
+      memcpy(buffer.data() + used, data, size);
+      used += size;
+    } else
+      saveBinarySlow(data, size);
+  }
+
+  /** Hides the hash map based version from cereal::OutputArchive.*/
+  std::uint32_t registerSharedPointer(const void* addr);
+
+  /** Writes out the buffered data and throws if that fails. Call it once everything is saved, the destructor
+      only writes out what's left as a fallback and can't report errors.*/
+  void flush();
+
+  private:
+  void saveBinarySlow(const void*, std::size_t);
+  bool writeBuffer();
+  void growPointerTable();
+  std::size_t getSlot(const void*) const;
+  std::ostream& stream;
+  std::vector<char> buffer;
+  std::size_t used = 0;
+  struct PointerEntry {
+    const void* addr;
+    std::uint32_t id;
+  };
+  std::vector<PointerEntry> pointerTable;
+  int pointerTableBits = 0;
+  std::uint32_t numPointers = 0;
+};
+
+class FlatInputArchive : public cereal::InputArchive<FlatInputArchive, cereal::AllowEmptyClassElision> {
+  public:
+  /** Reads ahead of the archive, so the stream shouldn't be used directly afterwards.*/
+  FlatInputArchive(std::istream&);
+  ~FlatInputArchive() CEREAL_NOEXCEPT = default;
+
+  void loadBinary(void* data, std::size_t size) {
+    if (size <= bufferEnd - bufferPos) {
+      memcpy(data, buffer.data() + bufferPos, size);
+      bufferPos += size;
+    } else
+      loadBinarySlow(data, size);
+  }
+
+  /** These hide the hash map based versions from cereal::InputArchive.*/
+  std::shared_ptr<void> getSharedPointer(std::uint32_t id);
+  void registerSharedPointer(std::uint32_t id, std::shared_ptr<void>);
+  std::string getPolymorphicName(std::uint32_t id);
+  void registerPolymorphicName(std::uint32_t id, const std::string&);
+
+  private:
+  void loadBinarySlow(void*, std::size_t);
+  std::istream& stream;
+  std::vector<char> buffer;
+  std::size_t bufferPos = 0;
+  std::size_t bufferEnd = 0;
+  std::vector<std::shared_ptr<void>> pointers;
+  std::vector<std::string> polymorphicNames;
+};
+
+template<class T> inline
+typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+CEREAL_SAVE_FUNCTION_NAME(FlatOutputArchive& ar, T const& t) {
+  ar.saveBinary(std::addressof(t), sizeof(t));
+}
+
+template<class T> inline
+typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+CEREAL_LOAD_FUNCTION_NAME(FlatInputArchive& ar, T& t) {
+  ar.loadBinary(std::addressof(t), sizeof(t));
+}
+
+template <class Archive, class T> inline
+CEREAL_ARCHIVE_RESTRICT(FlatInputArchive, FlatOutputArchive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::NameValuePair<T>& t) {
+  ar(t.value);
+}
+
+template <class Archive, class T> inline
+CEREAL_ARCHIVE_RESTRICT(FlatInputArchive, FlatOutputArchive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, cereal::SizeTag<T>& t) {
+  ar(t.size);
+}
+
+template <class T> inline
+void CEREAL_SAVE_FUNCTION_NAME(FlatOutputArchive& ar, cereal::BinaryData<T> const& bd) {
+  ar.saveBinary(bd.data, static_cast<std::size_t>(bd.size));
+}
+
+template <class T> inline
+void CEREAL_LOAD_FUNCTION_NAME(FlatInputArchive& ar, cereal::BinaryData<T>& bd) {
+  ar.loadBinary(bd.data, static_cast<std::size_t>(bd.size));
+}
+
+// register archives for polymorphic support
+CEREAL_REGISTER_ARCHIVE(FlatOutputArchive)
+CEREAL_REGISTER_ARCHIVE(FlatInputArchive)
+
+// tie input and output archives together
+CEREAL_SETUP_ARCHIVE_TRAITS(FlatInputArchive, FlatOutputArchive)
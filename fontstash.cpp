@@ -750,6 +750,81 @@ void sth_dim_text(struct sth_stash* stash,
 	if (floorf(x) > *maxx) *maxx = floorf(x);
 }
 
+int sth_layout_text(struct sth_stash* stash,
+					int idx, float size, float y,
+					const char* s,
+					struct sth_run_quad* quads, int maxquads, float* minx, float* maxx)
+{
+	unsigned int codepoint;
+	struct sth_glyph* glyph = NULL;
+	unsigned int state = 0;
+	struct sth_quad q;
+	short isize = (short)(size*10.0f);
+	struct sth_font* fnt = NULL;
+	float x = 0;
+	int count = 0;
+
+	*minx = *maxx = 0;
+
+	if (stash == NULL)
+        return 0;
+	fnt = stash->fonts;
+	while(fnt != NULL && fnt->idx != idx)
+        fnt = fnt->next;
+	if (fnt == NULL)
+        return 0;
+	if (fnt->type != BMFONT && !fnt->data)
+        return 0;
+	for (; *s; ++s)
+	{
+		if (decutf8(&state, &codepoint, *(unsigned char*)s))
+            continue;
+		glyph = get_glyph(stash, fnt, codepoint, isize);
+		if (!glyph)
+            continue;
+		if (!get_quad(stash, fnt, glyph, isize, &x, &y, &q))
+            continue;
+		if (q.x0 < *minx) *minx = q.x0;
+		if (q.x1 > *maxx) *maxx = q.x1;
+		if (count < maxquads)
+		{
+			struct sth_run_quad* r = &quads[count];
+			r->texture = glyph->texture;
+			r->x0 = q.x0; r->y0 = q.y0; r->s0 = q.s0; r->t0 = q.t0;
+			r->x1 = q.x1; r->y1 = q.y1; r->s1 = q.s1; r->t1 = q.t1;
+		}
+		++count;
+	}
+	if (floorf(x) > *maxx) *maxx = floorf(x);
+	return count;
+}
+
+void sth_draw_run(struct sth_stash* stash, const struct sth_run_quad* quads, int count, float x, float y)
+{
+	int i;
+	float* v;
+	struct sth_texture* texture = NULL;
+
+	if (stash == NULL)
+        return;
+	for (i = 0; i < count; ++i)
+	{
+		const struct sth_run_quad* q = &quads[i];
+		texture = q->texture;
+		if (texture->nverts+4 >= VERT_COUNT)
+			flush_draw(stash);
+
+		v = &texture->verts[texture->nverts*4];
+
+		v = setv(v, x + q->x0, y + q->y0, q->s0, q->t0);
+		v = setv(v, x + q->x1, y + q->y0, q->s1, q->t0);
+		v = setv(v, x + q->x1, y + q->y1, q->s1, q->t1);
+		v = setv(v, x + q->x0, y + q->y1, q->s0, q->t1);
+
+		texture->nverts += 4;
+	}
+}
+
 void sth_vmetrics(struct sth_stash* stash,
 				  int idx, float size,
 				  float* ascender, float* descender, float* lineh)
@@ -54,6 +54,23 @@ void sth_draw_text(struct sth_stash* stash,
 void sth_dim_text(struct sth_stash* stash, int idx, float size, const char* string,
 				  float* minx, float* miny, float* maxx, float* maxy);
 
+// A glyph quad laid out by sth_layout_text, relative to the start of the text.
+struct sth_run_quad
+{
+	struct sth_texture* texture;
+	float x0,y0,s0,t0;
+	float x1,y1,s1,t1;
+};
+
+// Lays out the text starting at (0, y) and writes up to maxquads quads. Returns the number of quads
+// in the whole text and its extents, like sth_dim_text. The quads stay valid until the stash is deleted.
+int sth_layout_text(struct sth_stash* stash, int idx, float size, float y, const char* string,
+					struct sth_run_quad* quads, int maxquads, float* minx, float* maxx);
+
+// Draws quads returned by sth_layout_text moved by (x, y). Must be called between sth_begin_draw and
+// sth_end_draw. Moving by whole pixels gives the same result as calling sth_draw_text at that position.
+void sth_draw_run(struct sth_stash* stash, const struct sth_run_quad* quads, int count, float x, float y);
+
 void sth_vmetrics(struct sth_stash* stash,
 				  int idx, float size,
 				  float* ascender, float* descender, float * lineh);
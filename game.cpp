@@ -40,8 +40,10 @@ void Game::serialize(Archive& ar, const unsigned int version) {
   ar(villainsByType, collectives, lastTick, playerControl, playerCollective, currentTime);
   ar(musicType, statistics, spectator, tribes, gameIdentifier, player);
   ar(gameDisplayName, finishCurrentMusic, models, visited, baseModel, campaign, localTime, turnEvents);
-  if (Archive::is_loading::value)
+  if (Archive::is_loading::value) {
     sunlightInfo.update(currentTime);
+    rebuildLevelCaches();
+  }
 }
 
 SERIALIZABLE(Game);
@@ -71,6 +73,8 @@ Game::Game(Table<PModel>&& m, Vec2 basePos, const CampaignSetup& c)
       }
       m->updateSunlightMovement();
     }
+  // Retired sites are loaded as separate models.
+  rebuildLevelCaches();
   turnEvents = {0, 10, 50, 100, 300, 500};
   for (int i : Range(200))
     turnEvents.insert(1000 * (i + 1));
@@ -133,6 +137,20 @@ vector<WModel> Game::getAllModels() const {
   return ret;
 }
 
+void Game::rebuildLevelCaches() {
+  // Models don't share any level state, so the worker threads just take the next model that's left.
+  auto allModels = getAllModels();
+  std::atomic<int> next(0);
+  vector<thread> threads;
+  for (int i : Range(min<int>(allModels.size(), max(1, (int) thread::hardware_concurrency()))))
+    threads.emplace_back([&] {
+      for (int index = next++; index < allModels.size(); index = next++)
+        allModels[index]->rebuildLevelCaches();
+    });
+  for (auto& t : threads)
+    t.join();
+}
+
 bool Game::isSingleModel() const {
   return models.getBounds().getSize() == Vec2(1, 1);
 }
@@ -159,9 +177,8 @@ void Game::prepareSiteRetirement() {
     }
   playerCollective->setVillainType(VillainType::MAIN);
   playerCollective->retire();
-  set<Position> locationPosTmp =
-      playerCollective->getConstructions().getBuiltPositions(FurnitureType::BOOKCASE);
-  vector<Position> locationPos(locationPosTmp.begin(), locationPosTmp.end());
+  vector<Position> locationPos =
+      asVector<Position>(playerCollective->getConstructions().getBuiltPositions(FurnitureType::BOOKCASE));
   if (locationPos.empty())
     locationPos = playerCollective->getTerritory().getAll();
   if (!locationPos.empty())
@@ -90,6 +90,7 @@ class Game : public OwnedObject<Game> {
 
   private:
   void updateSunlightInfo();
+  void rebuildLevelCaches();
   void tick(double time);
   PCreature makeAdventurer(int handicap);
   WModel getCurrentModel() const;
@@ -213,9 +213,8 @@ static optional<int> getNextActive(const vector<CollectiveInfo::Button>& buttons
   return i;
 }
 
-SGuiElem GuiBuilder::drawBuildings(const CollectiveInfo& info, const optional<TutorialInfo>& tutorial) {
+SGuiElem GuiBuilder::drawBuildings(const vector<CollectiveInfo::Button>& buttons, const optional<TutorialInfo>& tutorial) {
   vector<SGuiElem> keypressOnly;
-  auto& buttons = info.buildings;
   auto tab = CollectiveTab::BUILDINGS;
   auto elems = gui.getListBuilder(legendLineHeight);
   elems.addSpace(5);
@@ -274,8 +273,12 @@ SGuiElem GuiBuilder::drawBuildings(const CollectiveInfo& info, const optional<Tu
   return gui.scrollable(gui.stack(std::move(keypressOnly)));
 }
 
+static int getTechnologyHash(const CollectiveInfo& info) {
+  return combineHash(info.techButtons, info.workshopButtons);
+}
+
 SGuiElem GuiBuilder::drawTechnology(CollectiveInfo& info) {
-  int hash = combineHash(info.techButtons, info.workshopButtons);
+  int hash = getTechnologyHash(info);
   if (hash != technologyHash) {
     technologyHash = hash;
     auto lines = gui.getListBuilder(legendLineHeight);
@@ -402,9 +405,18 @@ const char* GuiBuilder::getCurrentGameSpeedName() const {
     return getGameSpeedName(gameSpeed);
 }
 
+// Only the parts of CollectiveInfo that are displayed in the minions tab, so that the list isn't
+// rebuilt when unrelated data, like the task map or the chosen creature, changes.
+static int getMinionsHash(const CollectiveInfo& info, const optional<TutorialInfo>& tutorial) {
+  return combineHash(info.monsterHeader, info.minions, info.minionGroups, info.enemyGroups, info.teams, tutorial);
+}
+
 SGuiElem GuiBuilder::drawRightBandInfo(GameInfo& info) {
   auto getIconHighlight = [&] (Color c) { return gui.topMargin(-1, gui.uiHighlight(c)); };
-  int hash = combineHash(info.collectiveInfo, info.villageInfo, info.modifiedSquares, info.totalSquares, info.tutorial);
+  modifiedSquares = info.modifiedSquares;
+  totalSquares = info.totalSquares;
+  int hash = combineHash(getMinionsHash(info.collectiveInfo, info.tutorial), info.collectiveInfo.buildings,
+      getTechnologyHash(info.collectiveInfo), info.villageInfo, info.tutorial, info.singleModel);
   if (hash != rightBandInfoHash) {
     rightBandInfoHash = hash;
     CollectiveInfo& collectiveInfo = info.collectiveInfo;
@@ -452,7 +464,7 @@ SGuiElem GuiBuilder::drawRightBandInfo(GameInfo& info) {
     vector<pair<CollectiveTab, SGuiElem>> elems = makeVec(
         make_pair(CollectiveTab::MINIONS, drawMinions(collectiveInfo, info.tutorial)),
         make_pair(CollectiveTab::BUILDINGS, cache->get(bindMethod(
-            &GuiBuilder::drawBuildings, this), THIS_LINE, info.collectiveInfo, info.tutorial)),
+            &GuiBuilder::drawBuildings, this), THIS_LINE, info.collectiveInfo.buildings, info.tutorial)),
         make_pair(CollectiveTab::KEY_MAPPING, drawKeeperHelp()),
         make_pair(CollectiveTab::TECHNOLOGY, drawTechnology(collectiveInfo)),
         make_pair(CollectiveTab::VILLAGES, drawVillages(villageInfo)));
@@ -476,8 +488,6 @@ SGuiElem GuiBuilder::drawRightBandInfo(GameInfo& info) {
             .addElemAuto(gui.labelFun([this] { return getCurrentGameSpeedName();},
               [this] { return clock->isPaused() ? Color::RED : Color::WHITE; })).buildHorizontalList(),
         gui.button([&] { gameSpeedDialogOpen = !gameSpeedDialogOpen; })), 160);
-    int modifiedSquares = info.modifiedSquares;
-    int totalSquares = info.totalSquares;
     bottomLine.addElemAuto(gui.stack(
         gui.labelFun([=]()->string {
           switch (counterMode) {
@@ -1343,7 +1353,7 @@ vector<SGuiElem> GuiBuilder::getSettingsButtons() {
 }
 
 SGuiElem GuiBuilder::drawMinions(CollectiveInfo& info, const optional<TutorialInfo>& tutorial) {
-  int newHash = info.getHash();
+  int newHash = getMinionsHash(info, tutorial);
   if (newHash != minionsHash) {
     minionsHash = newHash;
     auto list = gui.getListBuilder(legendLineHeight);
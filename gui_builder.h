@@ -143,7 +143,7 @@ class GuiBuilder {
   vector<SGuiElem> drawPlayerAttributes(const vector<PlayerInfo::AttributeInfo>&);
   SGuiElem drawPlayerLevelButton(const PlayerInfo&);
   SGuiElem getExpIncreaseLine(const PlayerInfo::LevelInfo&, ExperienceType);
-  SGuiElem drawBuildings(const CollectiveInfo&, const optional<TutorialInfo>&);
+  SGuiElem drawBuildings(const vector<CollectiveInfo::Button>&, const optional<TutorialInfo>&);
   SGuiElem bottomBandCache;
   SGuiElem drawMinionButtons(const vector<PlayerInfo>&, UniqueEntity<Creature>::Id current, optional<TeamId> teamId);
   SGuiElem minionButtonsCache;
@@ -181,6 +181,8 @@ class GuiBuilder {
   optional<OverlayInfo> speedDialog;
   int rightBandInfoHash = 0;
   SGuiElem rightBandInfoCache;
+  int modifiedSquares = 0;
+  int totalSquares = 0;
   SGuiElem immigrationCache;
   int immigrationHash = 0;
   optional<string> activeGroup;
@@ -41,6 +41,7 @@ vector<Highscores::Score> Highscores::fromStream(istream& in) {
 void Highscores::saveToFile(const vector<Score>& scores, const FilePath& path) {
   CompressedOutput out(path.getPath());
   out.getArchive() << scores;
+  out.getArchive().flush();
 }
 
 bool Highscores::Score::operator == (const Score& s) const {
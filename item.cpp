@@ -40,9 +40,12 @@ void Item::serialize(Archive& ar, const unsigned int version) {
 SERIALIZABLE(Item);
 SERIALIZATION_CONSTRUCTOR_IMPL(Item);
 
-Item::Item(const ItemAttributes& attr) : Renderable(ViewObject(*attr.viewId, ViewLayer::ITEM, *attr.name)),
-    attributes(attr), fire(*attr.weight, attr.flamability), canEquipCache(!!attributes->equipmentSlot),
-    classCache(*attributes->itemClass) {
+Item::Item(const ItemAttributes& attr) : Item(make_shared<ItemAttributes>(attr)) {
+}
+
+Item::Item(shared_ptr<ItemAttributes> attr) : Renderable(ViewObject(*attr->viewId, ViewLayer::ITEM, *attr->name)),
+    attributes(std::move(attr)), fire(*attributes->weight, attributes->flamability),
+    canEquipCache(!!attributes->equipmentSlot), classCache(*attributes->itemClass) {
 }
 
 Item::~Item() {
@@ -203,7 +206,7 @@ void Item::applySpecial(WCreature c) {
     c->getGame()->getStatistics().add(StatId::SCROLL_READ);
   if (attributes->effect)
     Effect::applyToCreature(c, *attributes->effect, EffectStrength::NORMAL);
-  if (attributes->uses > -1 && --attributes->uses == 0) {
+  if (attributes->uses > -1 && --modAttributes().uses == 0) {
     discarded = true;
     if (attributes->usedUpMsg)
       c->playerMessage(getTheName() + " is used up.");
@@ -251,7 +254,13 @@ string Item::getNoSeeApplyMsg() const {
 }
 
 void Item::setName(const string& n) {
-  attributes->name = n;
+  modAttributes().name = n;
+}
+
+ItemAttributes& Item::modAttributes() {
+  if (attributes.use_count() > 1)
+    attributes = make_shared<ItemAttributes>(*attributes);
+  return *attributes;
 }
 
 WCreature Item::getShopkeeper(WConstCreature owner) const {
@@ -412,7 +421,7 @@ EquipmentSlot Item::getEquipmentSlot() const {
 }
 
 void Item::addModifier(ModifierType type, int value) {
-  attributes->modifiers[type] += value;
+  modAttributes().modifiers[type] += value;
 }
 
 int Item::getModifier(ModifierType type) const {
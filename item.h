@@ -32,6 +32,8 @@ struct CorpseInfo;
 class Item : public Renderable, public UniqueEntity<Item>, public OwnedObject<Item> {
   public:
   Item(const ItemAttributes&);
+  /** Shares the attributes with other items. They are copied the first time this item modifies them.*/
+  Item(shared_ptr<ItemAttributes>);
   virtual ~Item();
 
   void apply(WCreature, bool noSound = false);
@@ -116,7 +118,8 @@ class Item : public Renderable, public UniqueEntity<Item>, public OwnedObject<It
   string getModifiers(bool shorten = false) const;
   string getVisibleName(bool plural) const;
   string getBlindName(bool plural) const;
-  HeapAllocated<ItemAttributes> SERIAL(attributes);
+  ItemAttributes& modAttributes();
+  shared_ptr<ItemAttributes> SERIAL(attributes);
   optional<UniqueEntity<Creature>::Id> SERIAL(shopkeeper);
   HeapAllocated<Fire> SERIAL(fire);
   bool SERIAL(canEquipCache);
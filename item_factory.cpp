@@ -745,10 +745,25 @@ PItem ItemFactory::fromId(ItemType item) {
     case ItemId::RANDOM_TECH_BOOK: return makeOwner<TechBook>(getAttributes(item), none);
     case ItemId::TECH_BOOK: return makeOwner<TechBook>(getAttributes(item), item.get<TechId>());
     case ItemId::POTION: return makeOwner<Potion>(getAttributes(item));
-    default: return makeOwner<Item>(getAttributes(item));
+    default: return makeOwner<Item>(getSharedAttributes(item));
   }
 }
 
+shared_ptr<ItemAttributes> ItemFactory::getSharedAttributes(ItemType item) {
+  // Items of these types don't have any random attributes, so they can all share a single copy.
+  static const map<ItemId, shared_ptr<ItemAttributes>> prototypes = [] {
+    map<ItemId, shared_ptr<ItemAttributes>> ret;
+    for (auto id : {ItemId::ARROW, ItemId::ROCK, ItemId::IRON_ORE, ItemId::STEEL_INGOT, ItemId::GOLD_PIECE,
+         ItemId::WOOD_PLANK, ItemId::BONE, ItemId::AUTOMATON_ITEM})
+      ret[id] = make_shared<ItemAttributes>(getAttributes(id));
+    return ret;
+  }();
+  auto it = prototypes.find(item.getId());
+  if (it != prototypes.end())
+    return it->second;
+  return make_shared<ItemAttributes>(getAttributes(item));
+}
+
 ItemAttributes ItemFactory::getAttributes(ItemType item) {
   switch (item.getId()) {
     case ItemId::KNIFE: return ITATTR(
@@ -65,6 +65,7 @@ class ItemFactory {
   struct ItemInfo;
   ItemFactory(const vector<ItemInfo>&);
   static ItemAttributes getAttributes(ItemType);
+  static shared_ptr<ItemAttributes> getSharedAttributes(ItemType);
   ItemFactory& addItem(ItemInfo);
   ItemFactory& addUniqueItem(ItemType, Range count = Range::singleElem(1));
   vector<ItemType> SERIAL(items);
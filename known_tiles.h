@@ -16,12 +16,13 @@
 
 #include "util.h"
 #include "position_map.h"
+#include "position_set.h"
 
 class KnownTiles {
   public:
   void addTile(Position);
   bool isKnown(Position) const;
-  const set<Position>& getBorderTiles() const;
+  const PositionSet& getBorderTiles() const;
   void limitToModel(const WModel);
 
   template <class Archive> 
@@ -29,6 +30,6 @@ class KnownTiles {
 
   private:
   PositionMap<bool> SERIAL(known);
-  set<Position> SERIAL(border);
+  PositionSet SERIAL(border);
 };
 
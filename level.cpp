@@ -37,15 +37,24 @@
 #include "field_of_view.h"
 #include "furniture.h"
 #include "furniture_array.h"
+#include "event_listener.h"
+#include "light_map.h"
+#include "poison_gas.h"
 
 template <class Archive> 
 void Level::serialize(Archive& ar, const unsigned int version) {
   ar & SUBCLASS(OwnedObject<Level>);
   ar(squares, oldSquares, landingSquares, tickingSquares, creatures, model, fieldOfView);
-  ar(name, sunlight, bucketMap, sectors, lightAmount, unavailable);
-  ar(levelId, noDiagonalPassing, lightCapAmount, creatureIds, memoryUpdates);
-  ar(furniture, tickingFurniture, covered);
-}  
+  ar(name, sunlight, unavailable);
+  ar(levelId, noDiagonalPassing, creatureIds);
+  ar(furniture, tickingFurniture, covered, creatureGrid, onFire, forbiddenTribe, poisonGas);
+  // Light, bucket map and memory updates are derived from the above and aren't saved.
+  // They are filled by rebuildCaches() once all the creatures are loaded.
+  if (Archive::is_loading::value) {
+    initCaches();
+    needsCacheRebuild = true;
+  }
+}
 
 SERIALIZABLE(Level);
 
@@ -55,11 +64,25 @@ Level::~Level() {}
 
 Level::Level(Private, SquareArray s, FurnitureArray f, WModel m, const string& n,
     Table<double> sun, LevelId id, Table<bool> cover)
-    : squares(std::move(s)), oldSquares(squares->getBounds()), furniture(std::move(f)),
-      memoryUpdates(squares->getBounds(), true), model(m),
-      name(n), sunlight(sun), covered(cover), bucketMap(squares->getBounds().width(), squares->getBounds().height(),
-      FieldOfView::sightRange), lightAmount(squares->getBounds(), 0), lightCapAmount(squares->getBounds(), 1),
-      levelId(id) {
+    : squares(std::move(s)), oldSquares(squares->getBounds()), furniture(std::move(f)), model(m),
+      name(n), sunlight(sun), covered(cover), creatureGrid(squares->getBounds()), onFire(squares->getBounds(), false),
+      forbiddenTribe(squares->getBounds()), poisonGas(squares->getBounds()), levelId(id) {
+  initCaches();
+}
+
+void Level::initCaches() {
+  memoryUpdates = Table<bool>(getBounds(), true);
+  *bucketMap = CreatureBucketMap(getBounds().width(), getBounds().height(), FieldOfView::sightRange);
+  lightMap.reset(new LightMap(getBounds(),
+      [this](Vec2 pos) { return getVisibleTilesNoDarkness(pos, VisionId::NORMAL); },
+      [this](Vec2 pos) { setNeedsRenderUpdate(pos, true); }));
+  for (Vec2 pos : getBounds())
+    poisonGas->setTransparent(pos, Position(pos, this).canSeeThru(VisionId::NORMAL));
+}
+
+void Level::addFurnitureLight(Vec2 pos, int num) {
+  for (auto f : Position(pos, this).getFurniture())
+    addLightSource(pos, f->getLightEmission(), num);
 }
 
 PLevel Level::create(SquareArray s, FurnitureArray f, WModel m, const string& n,
@@ -73,8 +96,18 @@ PLevel Level::create(SquareArray s, FurnitureArray f, WModel m, const string& n,
   }
   for (VisionId vision : ENUM_ALL(VisionId))
     (*ret->fieldOfView)[vision] = FieldOfView(ret.get(), vision);
-  for (auto pos : ret->getAllPositions())
-    ret->addLightSource(pos.getCoord(), pos.getLightEmission(), 1);
+  vector<Vec2> lightSources;
+  for (Vec2 pos : ret->getBounds())
+    for (auto f : Position(pos, ret.get()).getFurniture())
+      if (f->getLightEmission() > 0) {
+        lightSources.push_back(pos);
+        break;
+      }
+  // The light map needs the field of view of every source, which is the bulk of the work here. Light is summed
+  // in fixed point, so adding the sources afterwards gives the same result as before.
+  ret->getFieldOfView(VisionId::NORMAL).precompute(lightSources);
+  for (Vec2 pos : lightSources)
+    ret->addFurnitureLight(pos, 1);
   return ret;
 }
 
@@ -97,12 +130,26 @@ Rectangle Level::getSplashVisibleBounds() {
 
 const static double darknessRadius = 3.5;
 
+void Level::rebuildCaches() {
+  if (!needsCacheRebuild)
+    return;
+  needsCacheRebuild = false;
+  for (Vec2 pos : getBounds()) {
+    addFurnitureLight(pos, 1);
+    if (WCreature c = creatureGrid[pos]) {
+      bucketMap->addElement(pos, c);
+      if (c->isDarknessSource())
+        addDarknessSource(pos, darknessRadius, 1);
+    }
+  }
+}
+
 void Level::putCreature(Vec2 position, WCreature c) {
   CHECK(inBounds(position));
   creatures.push_back(c);
   creatureIds.insert(c);
-  CHECK(getSafeSquare(position)->getCreature() == nullptr)
-      << "Square occupied by " << getSafeSquare(position)->getCreature()->getName().bare();
+  CHECK(creatureGrid[position] == nullptr)
+      << "Square occupied by " << creatureGrid[position]->getName().bare();
   placeCreature(c, position);
 }
 
@@ -115,49 +162,19 @@ void Level::removeLightSource(Vec2 pos, double radius) {
 }
 
 void Level::addLightSource(Vec2 pos, double radius, int numLight) {
-  if (radius > 0) {
-    for (Vec2 v : getVisibleTilesNoDarkness(pos, VisionId::NORMAL)) {
-      double dist = (v - pos).lengthD();
-      if (dist <= radius) {
-        lightAmount[v] += min(1.0, 1 - (dist) / radius) * numLight;
-        setNeedsRenderUpdate(v, true);
-      }
-    }
-  }
+  lightMap->addLight(pos, radius, numLight);
 }
 
 void Level::addDarknessSource(Vec2 pos, double radius, int numDarkness) {
-  if (radius > 0) {
-    for (Vec2 v : getVisibleTilesNoDarkness(pos, VisionId::NORMAL)) {
-      double dist = (v - pos).lengthD();
-      if (dist <= radius) {
-        lightCapAmount[v] -= min(1.0, 1 - (dist) / radius) * numDarkness;
-        setNeedsRenderUpdate(v, true);
-      }
-//      updateConnectivity(v);
-    }
-  }
+  lightMap->addDarkness(pos, radius, numDarkness);
 }
 
 void Level::updateVisibility(Vec2 changedSquare) {
-  for (Vec2 pos : getVisibleTilesNoDarkness(changedSquare, VisionId::NORMAL)) {
-    addLightSource(pos, Position(pos, this).getLightEmission(), -1);
-    auto square = squares->getReadonly(pos);
-    CHECK(square) << pos << " " << getBounds();
-    if (WCreature c = square->getCreature())
-      if (c->isDarknessSource())
-        addDarknessSource(pos, darknessRadius, -1);
-  }
+  auto sources = lightMap->removeSourcesNear(changedSquare);
   for (VisionId vision : ENUM_ALL(VisionId))
     getFieldOfView(vision).squareChanged(changedSquare);
-  for (Vec2 pos : getVisibleTilesNoDarkness(changedSquare, VisionId::NORMAL)) {
-    addLightSource(pos, Position(pos, this).getLightEmission(), 1);
-    auto square = squares->getReadonly(pos);
-    CHECK(square) << pos << " " << getBounds();
-    if (WCreature c = square->getCreature())
-      if (c->isDarknessSource())
-        addDarknessSource(pos, darknessRadius, 1);
-  }
+  lightMap->restoreSources(sources);
+  poisonGas->setTransparent(changedSquare, Position(changedSquare, this).canSeeThru(VisionId::NORMAL));
 }
 
 WCreature Level::getPlayer() const {
@@ -181,12 +198,12 @@ WGame Level::getGame() const {
 }
 
 bool Level::isInSunlight(Vec2 pos) const {
-  return !covered[pos] && lightCapAmount[pos] == 1 &&
+  return !covered[pos] && lightMap->getLightCap(pos) == 1 &&
       getGame()->getSunlightInfo().getState() == SunlightState::DAY;
 }
 
 double Level::getLight(Vec2 pos) const {
-  return max(0.0, min(covered[pos] ? 1 : lightCapAmount[pos], lightAmount[pos] +
+  return max(0.0, min(covered[pos] ? 1 : lightMap->getLightCap(pos), lightMap->getLight(pos) +
       sunlight[pos] * getGame()->getSunlightInfo().getLightAmount()));
 }
 
@@ -307,7 +324,7 @@ void Level::throwItem(vector<PItem> item, const Attack& attack, int maxDist, Vec
         pos.minus(direction).dropItems(std::move(item));
       return;
     }
-    if (++cnt > maxDist || getSafeSquare(v)->itemLands(getWeakPointers(item), attack)) {
+    if (++cnt > maxDist || getSafeSquare(v)->itemLands(pos, getWeakPointers(item), attack)) {
       getGame()->addEvent({EventId::ITEMS_THROWN, EventInfo::ItemsThrown{this, getWeakPointers(item), trajectory}});
       modSafeSquare(v)->onItemLands(Position(v, this), std::move(item), attack, maxDist - cnt - 1, direction,
           vision);
@@ -437,7 +454,10 @@ void Level::moveCreature(WCreature creature, Vec2 direction) {
 
 void Level::unplaceCreature(WCreature creature, Vec2 pos) {
   bucketMap->removeElement(pos, creature);
-  modSafeSquare(pos)->removeCreature(Position(pos, this));
+  CHECK(creatureGrid[pos]);
+  creatureGrid[pos] = nullptr;
+  setNeedsMemoryUpdate(pos, true);
+  setNeedsRenderUpdate(pos, true);
   if (creature->isDarknessSource())   
     addDarknessSource(pos, darknessRadius, -1);
 }
@@ -446,7 +466,11 @@ void Level::placeCreature(WCreature creature, Vec2 pos) {
   Position position(pos, this);
   creature->setPosition(position);
   bucketMap->addElement(pos, creature);
-  modSafeSquare(pos)->putCreature(creature);
+  creatureGrid[pos] = creature;
+  setNeedsMemoryUpdate(pos, true);
+  setNeedsRenderUpdate(pos, true);
+  if (WGame game = creature->getGame())
+    game->addEvent({EventId::MOVED, creature});
   if (creature->isDarknessSource())
     addDarknessSource(pos, darknessRadius, 1);
   position.onEnter(creature);
@@ -502,6 +526,13 @@ void Level::tick() {
     for (auto layer : ENUM_ALL(FurnitureLayer))
       if (auto f = furniture->getBuilt(layer).getWritable(pos))
         f->tick(Position(pos, this));
+  poisonGas->tick([this](Vec2 pos, double amount) {
+    setNeedsMemoryUpdate(pos, true);
+    setNeedsRenderUpdate(pos, true);
+    if (amount > 0.2)
+      if (WCreature creature = creatureGrid[pos])
+        creature->poisonWithGas(min(1.0, amount));
+  });
 }
 
 bool Level::inBounds(Vec2 pos) const {
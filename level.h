@@ -24,6 +24,7 @@
 #include "entity_set.h"
 #include "vision_id.h"
 #include "furniture_layer.h"
+#include "tribe.h"
 
 class Model;
 class Square;
@@ -36,6 +37,8 @@ class Tribe;
 class Attack;
 class PlayerMessage;
 class CreatureBucketMap;
+class LightMap;
+class PoisonGas;
 class Position;
 class Game;
 class SquareArray;
@@ -179,6 +182,10 @@ class Level : public OwnedObject<Level> {
 
   void updateSunlightMovement();
 
+  /** Recomputes the light tables and the bucket map after loading. Must be called only once all creatures
+      are fully loaded, as it looks at their state.*/
+  void rebuildCaches();
+
   int getNumGeneratedSquares() const;
   int getNumTotalSquares() const;
   bool isUnavailable(Vec2) const;
@@ -200,7 +207,7 @@ class Level : public OwnedObject<Level> {
   HeapAllocated<SquareArray> SERIAL(squares);
   Table<PSquare> SERIAL(oldSquares);
   HeapAllocated<FurnitureArray> SERIAL(furniture);
-  Table<bool> SERIAL(memoryUpdates);
+  Table<bool> memoryUpdates;
   Table<bool> renderUpdates = Table<bool>(getMaxBounds(), true);
   Table<bool> SERIAL(unavailable);
   unordered_map<StairKey, vector<Position>> SERIAL(landingSquares);
@@ -216,10 +223,18 @@ class Level : public OwnedObject<Level> {
   string SERIAL(name);
   Table<double> SERIAL(sunlight);
   Table<bool> SERIAL(covered);
-  HeapAllocated<CreatureBucketMap> SERIAL(bucketMap);
-  Table<double> SERIAL(lightAmount);
-  Table<double> SERIAL(lightCapAmount);
-  mutable unordered_map<MovementType, Sectors> SERIAL(sectors);
+  // Per-tile state that is kept outside of Square, so that moving creatures around
+  // doesn't force every visited tile to allocate its own Square.
+  Table<WCreature> SERIAL(creatureGrid);
+  Table<bool> SERIAL(onFire);
+  Table<optional<TribeId>> SERIAL(forbiddenTribe);
+  HeapAllocated<PoisonGas> SERIAL(poisonGas);
+  HeapAllocated<CreatureBucketMap> bucketMap;
+  unique_ptr<LightMap> lightMap;
+  bool needsCacheRebuild = false;
+  void initCaches();
+  void addFurnitureLight(Vec2, int num);
+  mutable unordered_map<MovementType, Sectors> sectors;
   Sectors& getSectors(const MovementType&) const;
   
   friend class LevelBuilder;
@@ -17,7 +17,8 @@ LevelBuilder::LevelBuilder(ProgressMeter* meter, RandomGen& r, int width, int he
   : squares(Rectangle(width, height)), unavailable(width, height, false),
     heightMap(width, height, 0), covered(width, height, allCovered),
     sunlight(width, height, defaultLight ? *defaultLight : (allCovered ? 0.0 : 1.0)),
-    attrib(width, height), items(width, height), furniture(Rectangle(width, height)),
+    attrib(width, height), items(width, height),
+    furniture([&](FurnitureLayer) { return Table<std::uint16_t>(width, height, 0); }),
     name(n), progressMeter(meter), random(r) {
   for (Vec2 v : squares.getBounds())
     squares.putElem(v, {});
@@ -83,11 +84,18 @@ void LevelBuilder::putFurniture(Vec2 posT, FurnitureFactory& f, optional<SquareA
   putFurniture(posT, f.getRandom(getRandom()), attrib);
 }
 
+std::uint16_t LevelBuilder::getFurnitureId(const FurnitureParams& params) {
+  auto& id = furnitureTypeIds[params];
+  if (id == 0) {
+    CHECK(furnitureTypes.size() < std::numeric_limits<std::uint16_t>::max());
+    furnitureTypes.push_back(FurnitureTypeInfo{params, FurnitureFactory::get(params.type, params.tribe)});
+    id = furnitureTypes.size();
+  }
+  return id;
+}
+
 void LevelBuilder::putFurniture(Vec2 posT, FurnitureParams f, optional<SquareAttrib> attrib) {
-  auto layer = Furniture::getLayer(f.type);
-  if (getFurniture(posT, layer))
-    removeFurniture(posT, layer);
-  furniture.getBuilt(layer).putElem(transform(posT), f);
+  furniture[Furniture::getLayer(f.type)][transform(posT)] = getFurnitureId(f);
   if (attrib)
     addAttrib(posT, *attrib);
 }
@@ -107,7 +115,7 @@ bool LevelBuilder::canPutFurniture(Vec2 posT, FurnitureLayer layer) {
 }
 
 void LevelBuilder::removeFurniture(Vec2 pos, FurnitureLayer layer) {
-  furniture.getBuilt(layer).clearElem(transform(pos));
+  furniture[layer][transform(pos)] = 0;
 }
 
 void LevelBuilder::removeAllFurniture(Vec2 pos) {
@@ -127,7 +135,10 @@ bool LevelBuilder::isFurnitureType(Vec2 pos, FurnitureType type) {
 }
 
 WConstFurniture LevelBuilder::getFurniture(Vec2 posT, FurnitureLayer layer) {
-  return furniture.getBuilt(layer).getReadonly(transform(posT));
+  if (auto id = furniture[layer][transform(posT)])
+    return furnitureTypes[id - 1].prototype.get();
+  else
+    return nullptr;
 }
 
 void LevelBuilder::setLandingLink(Vec2 posT, StairKey key) {
@@ -157,7 +168,14 @@ PLevel LevelBuilder::build(WModel m, LevelMaker* maker, LevelId levelId) {
   for (Vec2 v : squares.getBounds())
     if (!items[v].empty())
       squares.getWritable(v)->dropItemsLevelGen(std::move(items[v]));
-  auto l = Level::create(std::move(squares), std::move(furniture), m, name, sunlight, levelId, covered);
+  FurnitureArray furnitureArray(squares.getBounds());
+  for (auto layer : ENUM_ALL(FurnitureLayer)) {
+    auto& built = furnitureArray.getBuilt(layer);
+    for (Vec2 v : squares.getBounds())
+      if (auto id = furniture[layer][v])
+        built.putElem(v, furnitureTypes[id - 1].params);
+  }
+  auto l = Level::create(std::move(squares), std::move(furnitureArray), m, name, sunlight, levelId, covered);
   l->unavailable = unavailable;
   for (pair<PCreature, Vec2>& c : creatures)
     Position(c.second, l.get()).addCreature(std::move(c.first));
@@ -229,7 +247,8 @@ bool LevelBuilder::canNavigate(Vec2 posT, const MovementType& movement) {
     return false;
   bool result = true;
   for (auto layer : ENUM_ALL(FurnitureLayer))
-    if (auto f = furniture.getBuilt(layer).getReadonly(pos)) {
+    if (auto id = furniture[layer][pos]) {
+      auto& f = furnitureTypes[id - 1].prototype;
       bool canEnter = f->getMovementSet().canEnter(movement, covered[pos], false, none);
       if (f->overridesMovement())
         return canEnter;
@@ -119,6 +119,7 @@ class LevelBuilder {
   
   private:
   Vec2 transform(Vec2);
+  std::uint16_t getFurnitureId(const FurnitureParams&);
   SquareArray squares;
   Table<bool> unavailable;
   Table<double> heightMap;
@@ -129,7 +130,16 @@ class LevelBuilder {
   Table<EnumSet<SquareAttrib>> attrib;
   vector<pair<PCreature, Vec2>> creatures;
   Table<vector<PItem>> items;
-  FurnitureArray furniture;
+  /** Level makers overwrite the same tiles many times, so furniture is kept as indices into furnitureTypes
+      and only put into a FurnitureArray in build(). Zero means no furniture.*/
+  EnumMap<FurnitureLayer, Table<std::uint16_t>> furniture;
+  struct FurnitureTypeInfo {
+    FurnitureParams params;
+    // Answers queries about the furniture during generation.
+    PFurniture prototype;
+  };
+  vector<FurnitureTypeInfo> furnitureTypes;
+  unordered_map<FurnitureParams, std::uint16_t, CustomHash<FurnitureParams>> furnitureTypeIds;
   string name;
   vector<Vec2::LinearMap> mapStack;
   ProgressMeter* progressMeter = nullptr;
@@ -996,16 +996,48 @@ class RandomLocations : public LevelMaker {
   }
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
-    vector<LocationPredicate::Precomputed> precomputed;
-    for (int i : All(insideMakers))
-      precomputed.push_back(predicate[i].precompute(builder, area));
+    vector<Candidates> candidates;
+    for (int i : All(insideMakers)) {
+      auto precomputed = predicate[i].precompute(builder, area);
+      int margin = minMargin.count(insideMakers[i].get()) ? minMargin.at(insideMakers[i].get()) : 0;
+      int width = sizes[i].first;
+      int height = sizes[i].second;
+      CHECK(fits(area, width, height, margin) || fits(area, height, width, margin))
+          << "Couldn't fit maker inside area.";
+      Candidates c;
+      c[0] = getCandidates(precomputed, area, width, height, margin);
+      c[1] = width == height ? c[0] : getCandidates(precomputed, area, height, width, margin);
+      if (c[0].empty() && c[1].empty())
+        failGen(); // "Failed to find free space for " << (int)sizes.size() << " areas";
+      candidates.push_back(std::move(c));
+    }
     for (int i : Range(3000))
-      if (tryMake(builder, precomputed, area))
+      if (tryMake(builder, candidates))
         return;
     failGen(); // "Failed to find free space for " << (int)sizes.size() << " areas";
   }
 
-  bool tryMake(LevelBuilder* builder, const vector<LocationPredicate::Precomputed>& precomputed, Rectangle area) {
+  private:
+  /** Top left corners of the rectangles that satisfy a maker's predicate, in both orientations.*/
+  using Candidates = std::array<vector<Vec2>, 2>;
+
+  static bool fits(Rectangle area, int width, int height, int margin) {
+    return width + 2 * margin < area.width() && height + 2 * margin < area.height();
+  }
+
+  static vector<Vec2> getCandidates(const LocationPredicate::Precomputed& precomputed, Rectangle area,
+      int width, int height, int margin) {
+    vector<Vec2> ret;
+    if (!fits(area, width, height, margin))
+      return ret;
+    for (Vec2 v : Rectangle(area.left() + margin, area.top() + margin,
+          area.right() - width - margin, area.bottom() - height - margin))
+      if (precomputed.apply(Rectangle(v, v + Vec2(width, height))))
+        ret.push_back(v);
+    return ret;
+  }
+
+  bool tryMake(LevelBuilder* builder, const vector<Candidates>& candidates) {
     vector<Rectangle> occupied;
     vector<Rectangle> makerBounds;
     vector<LevelBuilder::Rot> maps;
@@ -1016,22 +1048,20 @@ class RandomLocations : public LevelMaker {
       auto maker = insideMakers[i].get();
       int width = sizes[i].first;
       int height = sizes[i].second;
-      if (contains({LevelBuilder::CW1, LevelBuilder::CW3}, maps[i]))
+      bool rotated = contains({LevelBuilder::CW1, LevelBuilder::CW3}, maps[i]);
+      if (rotated)
         std::swap(width, height);
-      CHECK(width <= area.width() && height <= area.height());
-      int px;
-      int py;
+      auto& positions = candidates[i][rotated ? 1 : 0];
+      if (positions.empty())
+        return false;
+      Vec2 pos;
       int cnt = 1000;
       bool ok;
       do {
         Progress::checkIfInterrupted();
         ok = true;
-        int margin = minMargin.count(maker) ? minMargin.at(maker) : 0;
-        CHECK(width + 2 * margin < area.width()) << "Couldn't fit maker width inside area.";
-        CHECK(height + 2 * margin < area.height())  << "Couldn't fit maker height inside area.";
-        px = area.left() + margin + builder->getRandom().get(area.width() - width - 2 * margin);
-        py = area.top() + margin + builder->getRandom().get(area.height() - height - 2 * margin);
-        Rectangle area(px, py, px + width, py + height);
+        pos = positions[builder->getRandom().get(positions.size())];
+        Rectangle area(pos, pos + Vec2(width, height));
         for (int j : Range(i))
           if ((maxDistance.count({insideMakers[j].get(), maker}) &&
                 maxDistance[{insideMakers[j].get(), maker}] < area.middle().dist8(occupied[j].middle())) ||
@@ -1039,20 +1069,17 @@ class RandomLocations : public LevelMaker {
             ok = false;
             break;
           }
-        if (!precomputed[i].apply(area))
-          ok = false;
-        else
-          if (separate)
-            for (Rectangle r : occupied)
-              if (r.intersects(area)) {
-                ok = false;
-                break;
-              }
+        if (ok && separate)
+          for (Rectangle r : occupied)
+            if (r.intersects(area)) {
+              ok = false;
+              break;
+            }
       } while (!ok && --cnt > 0);
       if (cnt == 0)
         return false;
-      occupied.push_back(Rectangle(px, py, px + width, py + height));
-      makerBounds.push_back(Rectangle(px, py, px + sizes[i].first, py + sizes[i].second));
+      occupied.push_back(Rectangle(pos, pos + Vec2(width, height)));
+      makerBounds.push_back(Rectangle(pos, pos + Vec2(sizes[i].first, sizes[i].second)));
     }
     CHECK(insideMakers.size() == occupied.size());
     for (int i : All(insideMakers)) {
@@ -1063,7 +1090,6 @@ class RandomLocations : public LevelMaker {
     return true;
   }
 
-  private:
   vector<PLevelMaker> insideMakers;
   vector<pair<int, int>> sizes;
   vector<LocationPredicate> predicate;
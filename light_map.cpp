@@ -0,0 +1,93 @@
+#include "stdafx.h"
+#include "light_map.h"
+
+static const int fixedOne = 256;
+
+static int getContribution(double dist, double radius) {
+  return int(round(min(1.0, 1 - dist / radius) * fixedOne));
+}
+
+LightMap::LightMap(Rectangle bounds, VisibleTilesFun v, ChangedFun c)
+    : light(bounds, 0), darkness(bounds, 0), visibleTiles(v), onChanged(c) {
+}
+
+void LightMap::addToTables(Vec2 pos, const Source& source, double radius, bool isDarkness, int num) {
+  auto& table = isDarkness ? darkness : light;
+  for (Vec2 v : source.tiles) {
+    double dist = (v - pos).lengthD();
+    if (dist <= radius) {
+      table[v] += getContribution(dist, radius) * num;
+      onChanged(v);
+    }
+  }
+}
+
+void LightMap::apply(Vec2 pos, const Source& source, int sign) {
+  for (double radius : source.light)
+    addToTables(pos, source, radius, false, sign);
+  for (double radius : source.darkness)
+    addToTables(pos, source, radius, true, sign);
+}
+
+void LightMap::updateTiles(Vec2 pos, Source& source, double radius) {
+  source.radius = radius;
+  source.tiles = visibleTiles(pos).filter([&](Vec2 v) { return (v - pos).lengthD() <= radius; });
+}
+
+void LightMap::add(Vec2 pos, double radius, bool isDarkness, int num) {
+  if (radius <= 0 || num == 0)
+    return;
+  auto& source = sources[pos];
+  auto& radii = isDarkness ? source.darkness : source.light;
+  if (num > 0) {
+    if (radius > source.radius) {
+      apply(pos, source, -1);
+      updateTiles(pos, source, radius);
+      apply(pos, source, 1);
+    }
+    for (int i : Range(num))
+      radii.push_back(radius);
+  } else {
+    int removed = 0;
+    while (removed < -num && radii.removeElementMaybe(radius))
+      ++removed;
+    num = -removed;
+  }
+  addToTables(pos, source, radius, isDarkness, num);
+  if (source.light.empty() && source.darkness.empty())
+    sources.erase(pos);
+}
+
+void LightMap::addLight(Vec2 pos, double radius, int num) {
+  add(pos, radius, false, num);
+}
+
+void LightMap::addDarkness(Vec2 pos, double radius, int num) {
+  add(pos, radius, true, num);
+}
+
+vector<Vec2> LightMap::removeSourcesNear(Vec2 changed) {
+  vector<Vec2> ret;
+  for (auto& elem : sources)
+    if ((elem.first - changed).lengthD() <= elem.second.radius) {
+      apply(elem.first, elem.second, -1);
+      ret.push_back(elem.first);
+    }
+  return ret;
+}
+
+void LightMap::restoreSources(const vector<Vec2>& positions) {
+  for (Vec2 pos : positions) {
+    auto& source = sources.at(pos);
+    updateTiles(pos, source, source.radius);
+    apply(pos, source, 1);
+  }
+}
+
+double LightMap::getLight(Vec2 pos) const {
+  return double(light[pos]) / fixedOne;
+}
+
+double LightMap::getLightCap(Vec2 pos) const {
+  return 1 - double(darkness[pos]) / fixedOne;
+}
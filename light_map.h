@@ -0,0 +1,41 @@
+#pragma once
+
+#include "util.h"
+
+/** Light and darkness levels of a Level. Each source remembers the tiles that it lights up, so
+    that changing a tile only re-propagates the sources that could reach it. Light is kept in 8.8
+    fixed point, which also makes adding and removing sources exact.*/
+class LightMap {
+  public:
+  typedef function<vector<Vec2>(Vec2)> VisibleTilesFun;
+  typedef function<void(Vec2)> ChangedFun;
+  LightMap(Rectangle bounds, VisibleTilesFun, ChangedFun);
+
+  void addLight(Vec2, double radius, int num);
+  void addDarkness(Vec2, double radius, int num);
+
+  /** Takes back the light of all sources that might be affected by a change of visibility at the given
+      tile. They have to be put back using restoreSources() once the field of view is updated.*/
+  vector<Vec2> removeSourcesNear(Vec2);
+  void restoreSources(const vector<Vec2>&);
+
+  double getLight(Vec2) const;
+  double getLightCap(Vec2) const;
+
+  private:
+  struct Source {
+    vector<double> light;
+    vector<double> darkness;
+    vector<Vec2> tiles;
+    double radius = 0;
+  };
+  void apply(Vec2 pos, const Source&, int sign);
+  void addToTables(Vec2 pos, const Source&, double radius, bool darkness, int num);
+  void updateTiles(Vec2 pos, Source&, double radius);
+  void add(Vec2, double radius, bool darkness, int num);
+  map<Vec2, Source> sources;
+  Table<std::int16_t> light;
+  Table<std::int16_t> darkness;
+  VisibleTilesFun visibleTiles;
+  ChangedFun onChanged;
+};
@@ -37,6 +37,7 @@
 #include "clock.h"
 #include "skill.h"
 #include "parse_game.h"
+#include "gzstream.h"
 #include "version.h"
 #include "vision.h"
 #include "model_builder.h"
@@ -67,12 +68,12 @@
 #define USER_DIR "."
 #endif
 
-static void initializeRendererTiles(Renderer& r, const DirectoryPath& path) {
-  r.loadTilesFromDir(path.subdirectory("orig16"), Vec2(16, 16));
+static void initializeRendererTiles(Renderer& r, const DirectoryPath& path, const DirectoryPath& cachePath) {
+  r.loadTilesFromDir(path.subdirectory("orig16"), Vec2(16, 16), cachePath.file("tiles16.cache"));
 //  r.loadAltTilesFromDir(path + "/orig16_scaled", Vec2(24, 24));
-  r.loadTilesFromDir(path.subdirectory("orig24"), Vec2(24, 24));
+  r.loadTilesFromDir(path.subdirectory("orig24"), Vec2(24, 24), cachePath.file("tiles24.cache"));
 //  r.loadAltTilesFromDir(path + "/orig24_scaled", Vec2(36, 36));
-  r.loadTilesFromDir(path.subdirectory("orig30"), Vec2(30, 30));
+  r.loadTilesFromDir(path.subdirectory("orig30"), Vec2(30, 30), cachePath.file("tiles30.cache"));
 //  r.loadAltTilesFromDir(path + "/orig30_scaled", Vec2(45, 45));
 }
 
@@ -199,6 +200,7 @@ static po::parser getCommandLineFlags() {
   flags["steam"].description("Run with Steam");
   flags["no_minidump"].description("Don't write minidumps when crashed.");
   flags["single_thread"].description("Do operations like loading, saving and level generation without starting an extra thread.");
+  flags["pregenerate_sites"].description("Generate campaign enemy sites in the background while the campaign is being set up.");
   flags["user_dir"].type(po::string).description("Directory for options and save files");
   flags["data_dir"].type(po::string).description("Directory containing the game data");
   flags["upload_url"].type(po::string).description("URL for uploading maps");
@@ -253,6 +255,7 @@ static int keeperMain(po::parser& commandLineFlags) {
     return 0;
   }
   bool useSingleThread = commandLineFlags["single_thread"].was_set();
+  bool pregenerateSites = commandLineFlags["pregenerate_sites"].was_set();
   FatalLog.addOutput(DebugOutput::crash());
   FatalLog.addOutput(DebugOutput::toStream(std::cerr));
 #ifndef RELEASE
@@ -331,7 +334,7 @@ static int keeperMain(po::parser& commandLineFlags) {
   SokobanInput sokobanInput(freeDataPath.file("sokoban_input.txt"), userPath.file("sokoban_state.txt"));
   if (commandLineFlags["worldgen_test"].was_set()) {
     MainLoop loop(nullptr, &highscores, &fileSharing, freeDataPath, userPath, &options, &jukebox, &sokobanInput,
-        useSingleThread, forceGame);
+        useSingleThread, pregenerateSites, forceGame);
     vector<string> types;
     if (commandLineFlags["worldgen_maps"].was_set())
       types = split(commandLineFlags["worldgen_maps"].get().string, {','});
@@ -353,7 +356,7 @@ static int keeperMain(po::parser& commandLineFlags) {
       soundLibrary = new SoundLibrary(&options, audioDevice, paidDataPath.subdirectory("sound"));
   }
   if (tilesPresent)
-    initializeRendererTiles(renderer, paidDataPath.subdirectory("images"));
+    initializeRendererTiles(renderer, paidDataPath.subdirectory("images"), userPath);
   Tile::initialize(renderer, tilesPresent);
   unique_ptr<View> view;
   view.reset(WindowView::createDefaultView(
@@ -363,7 +366,7 @@ static int keeperMain(po::parser& commandLineFlags) {
 #endif
   view->initialize();
   MainLoop loop(view.get(), &highscores, &fileSharing, freeDataPath, userPath, &options, &jukebox, &sokobanInput,
-      useSingleThread, forceGame);
+      useSingleThread, pregenerateSites, forceGame);
   try {
     if (audioError)
       view->presentText("Failed to initialize audio. The game will be started without sound.", *audioError);
@@ -27,13 +27,17 @@
 #include "game_save_type.h"
 #include "exit_info.h"
 #include "tutorial.h"
+#include "site_pool.h"
 
 MainLoop::MainLoop(View* v, Highscores* h, FileSharing* fSharing, const DirectoryPath& freePath,
     const DirectoryPath& uPath, Options* o, Jukebox* j, SokobanInput* soko, bool singleThread,
-    optional<ForceGameInfo> force)
+    bool pregenerate, optional<ForceGameInfo> force)
       : view(v), dataFreePath(freePath), userPath(uPath), options(o), jukebox(j),
-        highscores(h), fileSharing(fSharing), useSingleThread(singleThread), forceGame(force),
-        sokobanInput(soko) {
+        highscores(h), fileSharing(fSharing), useSingleThread(singleThread),
+        pregenerateSites(pregenerate && !singleThread), forceGame(force), sokobanInput(soko) {
+}
+
+MainLoop::~MainLoop() {
 }
 
 vector<SaveFileInfo> MainLoop::getSaveFiles(const DirectoryPath& path, const string& suffix) {
@@ -54,7 +58,7 @@ static string getDateString(time_t t) {
   return buf;
 }
 
-static const int saveVersion = 1700;
+static const int saveVersion = 1800;
 
 static bool isCompatible(int loadedVersion) {
   return loadedVersion > 2 && loadedVersion <= saveVersion && loadedVersion / 100 == saveVersion / 100;
@@ -74,7 +78,7 @@ template <typename T>
 static T loadFromFile(const FilePath& filename, bool failSilently) {
   T obj;
   try {
-    CompressedInput input(filename.getPath());
+    PrefetchCompressedInput input(filename.getPath());
     string discard;
     SavedGameInfo discard2;
     int version;
@@ -99,19 +103,23 @@ static string stripFilename(string s) {
 }
 
 static void saveGame(PGame& game, const FilePath& path) {
-  CompressedOutput out(path.getPath());
+  ParallelCompressedOutput out(path.getPath());
   string name = game->getGameDisplayName();
   SavedGameInfo savedInfo = game->getSavedGameInfo();
   out.getArchive() << saveVersion << name << savedInfo;
   out.getArchive() << game;
+  out.getArchive().flush();
+  out.getStream().close();
 }
 
 static void saveMainModel(PGame& game, const FilePath& path) {
-  CompressedOutput out(path.getPath());
+  ParallelCompressedOutput out(path.getPath());
   string name = game->getGameDisplayName();
   SavedGameInfo savedInfo = game->getSavedGameInfo();
   out.getArchive() << saveVersion << name << savedInfo;
   out.getArchive() << game->getMainModel();
+  out.getArchive().flush();
+  out.getStream().close();
 }
 
 int MainLoop::getSaveVersion(const SaveFileInfo& save) {
@@ -200,6 +208,7 @@ int MainLoop::getAutosaveFreq() {
 }
 
 void MainLoop::playGame(PGame&& game, bool withMusic, bool noAutoSave) {
+  sitePool.reset();
   view->reset();
   game->initialize(options, highscores, view, fileSharing);
   const milliseconds stepTimeMilli {3};
@@ -302,7 +311,8 @@ PGame MainLoop::prepareTutorial() {
 PGame MainLoop::prepareCampaign(RandomGen& random, const optional<ForceGameInfo>& forceGameInfo) {
   if (forceGameInfo) {
     CampaignBuilder builder(view, random, options, forceGameInfo->role);
-    auto result = builder.prepareCampaign(bindMethod(&MainLoop::getRetiredGames, this), forceGameInfo->type);
+    auto result = builder.prepareCampaign(bindMethod(&MainLoop::getRetiredGames, this), forceGameInfo->type,
+        getSitePrefetch());
     return Game::campaignGame(prepareCampaignModels(*result, random), *result);
   }
   auto choice = PlayerRoleChoice(PlayerRole::KEEPER);
@@ -311,10 +321,14 @@ PGame MainLoop::prepareCampaign(RandomGen& random, const optional<ForceGameInfo>
     if (auto ret = choice.match(
         [&] (PlayerRole role) -> optional<PGame> {
           CampaignBuilder builder(view, random, options, role);
-          if (auto result = builder.prepareCampaign(bindMethod(&MainLoop::getRetiredGames, this), CampaignType::CAMPAIGN)) {
+          if (auto result = builder.prepareCampaign(bindMethod(&MainLoop::getRetiredGames, this), CampaignType::CAMPAIGN,
+              getSitePrefetch())) {
             return Game::campaignGame(prepareCampaignModels(*result, random), *result);
-          } else
+          } else {
+            // Don't keep generating sites for a campaign that was abandoned.
+            sitePool.reset();
             return none;
+          }
         },
         [&] (NonRoleChoice choice) -> optional<PGame> {
           switch (choice) {
@@ -417,6 +431,12 @@ void MainLoop::start(bool tilesPresent) {
   }
 }
 
+// Random is thread local, so the new thread continues with a seed drawn from the caller's generator.
+static function<void()> withRandomSeed(function<void()> fun) {
+  int seed = Random.get(1 << 30);
+  return [fun, seed] { Random.init(seed); fun(); };
+}
+
 #ifdef OSX // see thread comment in stdafx.h
 static thread::attributes getAttributes() {
   thread::attributes attr;
@@ -425,13 +445,13 @@ static thread::attributes getAttributes() {
 }
 
 static thread makeThread(function<void()> fun) {
-  return thread(getAttributes(), fun);
+  return thread(getAttributes(), withRandomSeed(fun));
 }
 
 #else
 
 static thread makeThread(function<void()> fun) {
-  return thread(fun);
+  return thread(withRandomSeed(fun));
 }
 
 #endif
@@ -492,7 +512,19 @@ PModel MainLoop::getBaseModel(ModelBuilder& modelBuilder, CampaignSetup& setup)
   return ret;
 }
 
+function<void(const Campaign&)> MainLoop::getSitePrefetch() {
+  if (!pregenerateSites)
+    return nullptr;
+  return [this] (const Campaign& campaign) {
+    if (!sitePool)
+      sitePool.reset(new SitePool(options));
+    sitePool->prefetch(campaign);
+  };
+}
+
 Table<PModel> MainLoop::prepareCampaignModels(CampaignSetup& setup, RandomGen& random) {
+  if (sitePool)
+    sitePool->stop();
   Table<PModel> models(setup.campaign.getSites().getBounds());
   auto& sites = setup.campaign.getSites();
   for (Vec2 v : sites.getBounds())
@@ -511,9 +543,12 @@ Table<PModel> MainLoop::prepareCampaignModels(CampaignSetup& setup, RandomGen& r
             meter.addProgress();
           if (sites[v].getKeeper()) {
             models[v] = getBaseModel(modelBuilder, setup);
-          } else if (auto villain = sites[v].getVillain())
-            models[v] = modelBuilder.campaignSiteModel("Campaign enemy site", villain->enemyId, villain->type);
-          else if (auto retired = sites[v].getRetired()) {
+          } else if (auto villain = sites[v].getVillain()) {
+            if (PModel m = sitePool ? sitePool->take(villain->enemyId, villain->type) : nullptr)
+              models[v] = std::move(m);
+            else
+              models[v] = modelBuilder.campaignSiteModel("Campaign enemy site", villain->enemyId, villain->type);
+          } else if (auto retired = sites[v].getRetired()) {
             if (PModel m = loadFromFile<PModel>(userPath.file(retired->fileInfo.filename), !useSingleThread))
               models[v] = std::move(m);
             else {
@@ -18,6 +18,7 @@ class GameEvents;
 class SokobanInput;
 struct CampaignSetup;
 class ModelBuilder;
+class SitePool;
 
 class MainLoop {
   public:
@@ -26,7 +27,8 @@ class MainLoop {
     CampaignType type;
   };
   MainLoop(View*, Highscores*, FileSharing*, const DirectoryPath& dataFreePath, const DirectoryPath& userPath,
-      Options*, Jukebox*, SokobanInput*, bool useSingleThread, optional<ForceGameInfo>);
+      Options*, Jukebox*, SokobanInput*, bool useSingleThread, bool pregenerateSites, optional<ForceGameInfo>);
+  ~MainLoop();
 
   void start(bool tilesPresent);
   void modelGenTest(int numTries, const vector<std::string>& types, RandomGen&, Options*);
@@ -58,6 +60,7 @@ class MainLoop {
   void playMenuMusic();
 
   Table<PModel> prepareCampaignModels(CampaignSetup& campaign, RandomGen& random);
+  function<void(const Campaign&)> getSitePrefetch();
   PGame loadGame(const FilePath&);
   PGame loadPrevious();
   FilePath getSavePath(const PGame&, GameSaveType);
@@ -75,6 +78,8 @@ class MainLoop {
   Highscores* highscores;
   FileSharing* fileSharing;
   bool useSingleThread;
+  bool pregenerateSites;
+  unique_ptr<SitePool> sitePool;
   optional<ForceGameInfo> forceGame;
   SokobanInput* sokobanInput;
   PModel getBaseModel(ModelBuilder&, CampaignSetup&);
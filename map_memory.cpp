@@ -20,35 +20,87 @@
 #include "view_object.h"
 #include "view_index.h"
 
-SERIALIZE_DEF(MapMemory, table)
+template <class Archive>
+void MapMemory::serialize(Archive& ar, const unsigned int) {
+  ar(table, objects);
+  if (Archive::is_loading::value)
+    for (int i : All(objects))
+      objectIndex[objects[i]] = i;
+}
+
+SERIALIZABLE(MapMemory);
 
 MapMemory::MapMemory() {}
 
+MapMemory::Tile::Tile() {
+  objects.fill(-1);
+}
+
+bool MapMemory::Tile::isEmpty() const {
+  for (int index : objects)
+    if (index > -1)
+      return false;
+  return true;
+}
+
+bool MapMemory::Object::operator == (const Object& o) const {
+  return id == o.id && layer == o.layer && modifiers == o.modifiers && attachmentDir == o.attachmentDir &&
+      waterDepth == o.waterDepth && description == o.description;
+}
+
+int MapMemory::getObjectIndex(const ViewObject& obj) {
+  Object object {obj.id(), obj.layer(), {}, obj.getAttachmentDir(),
+      obj.getAttribute(ViewObject::Attribute::WATER_DEPTH), obj.getDescription()};
+  for (auto modifier : ENUM_ALL(ViewObject::Modifier))
+    if (obj.hasModifier(modifier))
+      object.modifiers.insert(modifier);
+  if (auto index = getValueMaybe(objectIndex, object))
+    return *index;
+  objects.push_back(object);
+  objectIndex[object] = objects.size() - 1;
+  return objects.size() - 1;
+}
+
 void MapMemory::addObject(Position pos, const ViewObject& obj) {
   CHECK(pos.isValid());
-  if (!getViewIndex(pos))
-    getViewIndex(pos) = ViewIndex();
-  getViewIndex(pos)->insert(obj);
-  getViewIndex(pos)->setHighlight(HighlightType::MEMORY);
+  table->getOrInit(pos).objects[int(obj.layer())] = getObjectIndex(obj);
   updateUpdated(pos);
 }
 
-optional<ViewIndex>& MapMemory::getViewIndex(Position pos) {
-  return table->getOrInit(pos);
+optional<ViewIndex> MapMemory::getViewIndex(Position pos) const {
+  auto& tile = table->get(pos);
+  if (tile.isEmpty())
+    return none;
+  ViewIndex ret;
+  for (int index : tile.objects)
+    if (index > -1) {
+      auto& object = objects[index];
+      ViewObject obj(object.id, object.layer, object.description);
+      for (auto modifier : object.modifiers)
+        obj.setModifier(modifier);
+      if (object.attachmentDir)
+        obj.setAttachmentDir(*object.attachmentDir);
+      if (object.waterDepth)
+        obj.setAttribute(ViewObject::Attribute::WATER_DEPTH, *object.waterDepth);
+      ret.insert(obj);
+    }
+  ret.setHighlight(HighlightType::MEMORY);
+  return ret;
 }
 
-const optional<ViewIndex>& MapMemory::getViewIndex(Position pos) const {
-  return table->get(pos);
+bool MapMemory::isRemembered(Position pos) const {
+  return !table->get(pos).isEmpty();
 }
 
-void MapMemory::update(Position pos, const ViewIndex& index1) {
+void MapMemory::update(Position pos, const ViewIndex& index) {
   CHECK(pos.isValid());
-  auto& index = getViewIndex(pos); 
-  index = index1;
-  index->setHighlight(HighlightType::MEMORY);
-  if (index->hasObject(ViewLayer::CREATURE) && 
-      !index->getObject(ViewLayer::CREATURE).hasModifier(ViewObjectModifier::REMEMBER))
-    index->removeObject(ViewLayer::CREATURE);
+  auto& tile = table->getOrInit(pos);
+  for (auto layer : ENUM_ALL(ViewLayer))
+    if (index.hasObject(layer) && (layer != ViewLayer::CREATURE ||
+          index.getObject(layer).hasModifier(ViewObjectModifier::REMEMBER)))
+      tile.objects[int(layer)] = getObjectIndex(index.getObject(layer));
+    else
+      tile.objects[int(layer)] = -1;
   updateUpdated(pos);
 }
 
@@ -58,7 +110,7 @@ void MapMemory::updateUpdated(Position pos) {
 }
 
 void MapMemory::clearSquare(Position pos) {
-  getViewIndex(pos) = none;
+  table->getOrInit(pos) = Tile();
 }
 
 const MapMemory& MapMemory::empty() {
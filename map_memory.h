@@ -19,10 +19,16 @@
 #include "position.h"
 #include "position_map.h"
 #include "hashing.h"
+#include "view_id.h"
+#include "view_layer.h"
+#include "view_object.h"
 
 class ViewObject;
 class ViewIndex;
 
+/** Remembered tiles of a player. Each tile keeps only an index per ViewLayer into a table of distinct
+    remembered objects, which is shared by all tiles. The objects are reduced to what's needed to draw
+    them and show their name. A ViewIndex is built from them only when a tile is queried.*/
 class MapMemory {
   public:
   MapMemory();
@@ -32,14 +38,35 @@ class MapMemory {
   void clearUpdated(WConstLevel) const;
   void clearSquare(Position pos);
   static const MapMemory& empty();
-  const optional<ViewIndex>& getViewIndex(Position) const;
+  optional<ViewIndex> getViewIndex(Position) const;
+  bool isRemembered(Position) const;
+
+  struct Tile {
+    Tile();
+    std::array<int, EnumInfo<ViewLayer>::size> SERIAL(objects);
+    bool isEmpty() const;
+    SERIALIZE_ALL(objects)
+  };
 
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
   private:
+  struct Object {
+    ViewId SERIAL(id);
+    ViewLayer SERIAL(layer);
+    EnumSet<ViewObjectModifier> SERIAL(modifiers);
+    optional<Dir> SERIAL(attachmentDir);
+    optional<float> SERIAL(waterDepth);
+    string SERIAL(description);
+    bool operator == (const Object&) const;
+    HASH_ALL(id, layer, modifiers, attachmentDir, waterDepth, description)
+    SERIALIZE_ALL(id, layer, modifiers, attachmentDir, waterDepth, description)
+  };
+  int getObjectIndex(const ViewObject&);
   void updateUpdated(Position);
-  optional<ViewIndex>& getViewIndex(Position);
-  HeapAllocated<PositionMap<optional<ViewIndex>>> SERIAL(table);
+  HeapAllocated<PositionMap<Tile>> SERIAL(table);
+  vector<Object> SERIAL(objects);
+  unordered_map<Object, int, CustomHash<Object>> objectIndex;
   mutable map<int, unordered_set<Position, CustomHash<Position>>> updated;
 };
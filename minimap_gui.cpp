@@ -25,20 +25,25 @@
 #include "view_object.h"
 
 void MinimapGui::renderMap(Renderer& renderer, Rectangle target) {
-  if (!mapBufferTex)
+  SDL::SDL_Surface* mapBuffer = currentMap ? currentMap->buffer : emptyBuffer;
+  if (!mapBufferTex) {
     mapBufferTex.emplace(mapBuffer);
-  else if (auto error = mapBufferTex->loadFromMaybe(mapBuffer))
-    FATAL << "Failed to render minimap, error: " << toString(*error);
+    dirty.pop();
+  } else
+    for (auto& region : dirty.pop())
+      if (auto error = mapBufferTex->updateRegionMaybe(mapBuffer, region))
+        FATAL << "Failed to render minimap, error: " << toString(*error);
   renderer.drawImage(target, info.bounds, *mapBufferTex);
   Vec2 topLeft = target.topLeft();
   double scale = min(double(target.width()) / info.bounds.width(),
       double(target.width()) / info.bounds.height());
-  for (Vec2 v : info.roads) {
-    Vec2 rrad(1, 1);
-    Vec2 pos = topLeft + (v - info.bounds.topLeft()) * scale;
-    if (pos.inRectangle(target.minusMargin(rrad.x)))
-      renderer.drawFilledRectangle(Rectangle(pos - rrad, pos + rrad), Color::BROWN);
-  }
+  if (currentMap)
+    for (Vec2 v : currentMap->roads) {
+      Vec2 rrad(1, 1);
+      Vec2 pos = topLeft + (v - info.bounds.topLeft()) * scale;
+      if (pos.inRectangle(target.minusMargin(rrad.x)))
+        renderer.drawFilledRectangle(Rectangle(pos - rrad, pos + rrad), Color::BROWN);
+    }
   Vec2 rad(3, 3);
   Vec2 player = topLeft + (info.player - info.bounds.topLeft()) * scale;
   if (player.inRectangle(target.minusMargin(rad.x)))
@@ -74,13 +79,22 @@ static Vec2 getMapBufferSize() {
   return Vec2(w, h);
 }
 
-MinimapGui::MinimapGui(Renderer& r, function<void()> f) : clickFun(f), renderer(r) {
+static const int dirtyBlockSize = 32;
+
+MinimapGui::MinimapGui(Renderer& r, function<void()> f) : clickFun(f),
+    dirty(Rectangle(getMapBufferSize()), dirtyBlockSize), renderer(r) {
   auto size = getMapBufferSize();
-  mapBuffer = Renderer::createSurface(size.x, size.y);
+  emptyBuffer = Renderer::createSurface(size.x, size.y);
 }
 
 void MinimapGui::clear() {
   currentLevel = nullptr;
+  currentMap = nullptr;
+  currentMemory = nullptr;
+  for (auto& elem : levelMaps)
+    SDL::SDL_FreeSurface(elem.second.buffer);
+  levelMaps.clear();
+  dirty.addAll();
   info = MinimapInfo {};
 }
 
@@ -92,30 +106,46 @@ bool MinimapGui::onLeftClick(Vec2 v) {
   return false;
 }
 
+void MinimapGui::putMapPixel(Position pos) {
+  Vec2 coord = pos.getCoord();
+  CHECK(coord.x < currentMap->buffer->w && coord.y < currentMap->buffer->h) << coord;
+  Renderer::putPixel(currentMap->buffer, coord, Tile::getColor(pos.getViewObject()));
+  if (pos.getViewObject().hasModifier(ViewObject::Modifier::ROAD))
+    currentMap->roads.insert(coord);
+  dirty.add(coord);
+}
+
+void MinimapGui::setLevel(WConstLevel level, const MapMemory& memory) {
+  if (currentMemory != &memory) {
+    clear();
+    currentMemory = &memory;
+  }
+  currentLevel = level;
+  auto id = level->getUniqueId();
+  if (!levelMaps.count(id)) {
+    // Tiles remembered before the level was first shown aren't in the updated set, so they are drawn here.
+    auto size = getMapBufferSize();
+    levelMaps[id].buffer = Renderer::createSurface(size.x, size.y);
+    SDL::SDL_FillRect(levelMaps[id].buffer, nullptr, SDL_MapRGBA(levelMaps[id].buffer->format, 0, 0, 0, 1));
+    currentMap = &levelMaps[id];
+    for (Position v : level->getAllPositions())
+      if (memory.isRemembered(v))
+        putMapPixel(v);
+    memory.clearUpdated(level);
+  }
+  currentMap = &levelMaps[id];
+  dirty.addAll();
+}
+
 void MinimapGui::update(WConstLevel level, Rectangle bounds, const CreatureView* creature) {
   info.bounds = bounds;
   info.enemies.clear();
   info.locations.clear();
   const MapMemory& memory = creature->getMemory();
-  if (currentLevel != level) {
-    int col = SDL_MapRGBA(mapBuffer->format, 0, 0, 0, 1);
-    SDL_FillRect(mapBuffer, nullptr, col);
-    info.roads.clear();
-    for (Position v : level->getAllPositions()) {
-      if (memory.getViewIndex(v)) {
-        Renderer::putPixel(mapBuffer, v.getCoord(), Tile::getColor(v.getViewObject()));
-        if (v.getViewObject().hasModifier(ViewObject::Modifier::ROAD))
-          info.roads.insert(v.getCoord());
-      }
-    }
-    currentLevel = level;
-  }
-  for (Position v : memory.getUpdated(level)) {
-    CHECK(v.getCoord().x < mapBuffer->w && v.getCoord().y < mapBuffer->h) << v.getCoord();
-    Renderer::putPixel(mapBuffer, v.getCoord(), Tile::getColor(v.getViewObject()));
-    if (v.getViewObject().hasModifier(ViewObject::Modifier::ROAD))
-      info.roads.insert(v.getCoord());
-  }
+  if (currentLevel != level || currentMemory != &memory)
+    setLevel(level, memory);
+  for (Position v : memory.getUpdated(level))
+    putMapPixel(v);
   memory.clearUpdated(level);
   info.player = creature->getPosition();
   for (Vec2 pos : creature->getVisibleEnemies())
@@ -18,10 +18,13 @@
 #include "util.h"
 #include "gui_elem.h"
 #include "hashing.h"
+#include "dirty_regions.h"
 
 class Level;
 class CreatureView;
 class Renderer;
+class MapMemory;
+class Position;
 
 class MinimapGui : public GuiElem {
   public:
@@ -38,11 +41,11 @@ class MinimapGui : public GuiElem {
   private:
 
   void renderMap(Renderer&, Rectangle target);
-  void putMapPixel(Vec2 pos, Color col);
+  void putMapPixel(Position);
+  void setLevel(WConstLevel, const MapMemory&);
 
   struct MinimapInfo {
     Rectangle bounds;
-    unordered_set<Vec2, CustomHash<Vec2>> roads;
     vector<Vec2> enemies;
     Vec2 player;
     vector<Vec2> locations;
@@ -50,7 +53,17 @@ class MinimapGui : public GuiElem {
 
   function<void()> clickFun;
 
-  SDL::SDL_Surface* mapBuffer;
+  // Every visited level keeps its own buffer, so that coming back to it only needs to draw the tiles
+  // remembered in the meantime.
+  struct LevelMap {
+    SDL::SDL_Surface* buffer;
+    unordered_set<Vec2, CustomHash<Vec2>> roads;
+  };
+  map<LevelId, LevelMap> levelMaps;
+  SDL::SDL_Surface* emptyBuffer;
+  LevelMap* currentMap = nullptr;
+  const MapMemory* currentMemory = nullptr;
+  DirtyRegions dirty;
   optional<Texture> mapBufferTex;
   WConstLevel currentLevel = nullptr;
   Renderer& renderer;
@@ -230,36 +230,87 @@ WItem MinionEquipment::getWorstItem(WConstCreature c, vector<WItem> items) const
   return ret;
 }
 
-void MinionEquipment::autoAssign(WConstCreature creature, vector<WItem> possibleItems) {
-  map<EquipmentSlot, vector<WItem>> slots;
+MinionEquipment::SlotItems MinionEquipment::getEquippedSlots(WConstCreature creature) const {
+  SlotItems slots;
   for (WItem it : getItemsOwnedBy(creature))
     if (it->canEquip()) {
       EquipmentSlot slot = it->getEquipmentSlot();
       slots[slot].push_back(it);
     }
+  return slots;
+}
+
+bool MinionEquipment::tryToAssign(WConstCreature creature, WItem it, SlotItems& slots) {
+  if (getOwner(it) || !needsItem(creature, it))
+    return false;
+  if (!it->canEquip()) {
+    CHECK(tryToOwn(creature, it));
+    return true;
+  }
+  WItem replacedItem = getWorstItem(creature, slots[it->getEquipmentSlot()]);
+  int slotSize = creature->getEquipment().getMaxItems(it->getEquipmentSlot());
+  int numInSlot = slots[it->getEquipmentSlot()].size();
+  if (numInSlot < slotSize ||
+      (replacedItem && getItemValue(replacedItem) < getItemValue(it))) {
+    if (numInSlot == slotSize) {
+      discard(replacedItem);
+      slots[it->getEquipmentSlot()].removeElement(replacedItem);
+    }
+    CHECK(tryToOwn(creature, it));
+    slots[it->getEquipmentSlot()].push_back(it);
+    return true;
+  }
+  return false;
+}
+
+void MinionEquipment::autoAssign(WConstCreature creature, vector<WItem> possibleItems) {
+  auto slots = getEquippedSlots(creature);
   sortByEquipmentValue(possibleItems);
   for (WItem it : possibleItems)
-    if (!getOwner(it) && needsItem(creature, it)) {
-      if (!it->canEquip()) {
-        CHECK(tryToOwn(creature, it));
-        if (it->getClass() != ItemClass::AMMO)
+    if (tryToAssign(creature, it, slots) && it->getClass() != ItemClass::AMMO)
+      break;
+}
+
+// Takes the best item that the creature needs from the sorted list, plus all needed ammo that comes before it.
+// Assigned items are removed from the list, so the next creatures don't look at them again.
+void MinionEquipment::assignFirstNeeded(WConstCreature creature, vector<WItem>& sortedItems, SlotItems& slots) {
+  for (int i = 0; i < sortedItems.size(); ++i) {
+    WItem it = sortedItems[i];
+    if (it->canEquip()) {
+      // Once the slot is full, the following items are no better than this one, so they can't replace
+      // anything either.
+      auto slot = it->getEquipmentSlot();
+      if (slots[slot].size() >= creature->getEquipment().getMaxItems(slot)) {
+        WItem worst = getWorstItem(creature, slots[slot]);
+        if (!worst || getItemValue(worst) >= getItemValue(it))
           break;
-        else
-          continue;
       }
-      WItem replacedItem = getWorstItem(creature, slots[it->getEquipmentSlot()]);
-      int slotSize = creature->getEquipment().getMaxItems(it->getEquipmentSlot());
-      int numInSlot = slots[it->getEquipmentSlot()].size();
-      if (numInSlot < slotSize ||
-          (replacedItem && getItemValue(replacedItem) < getItemValue(it))) {
-        if (numInSlot == slotSize) {
-          discard(replacedItem);
-          slots[it->getEquipmentSlot()].removeElement(replacedItem);
-        }
-        CHECK(tryToOwn(creature, it));
-        slots[it->getEquipmentSlot()].push_back(it);
+    }
+    if (tryToAssign(creature, it, slots)) {
+      sortedItems.removeIndexPreserveOrder(i--);
+      if (it->getClass() != ItemClass::AMMO)
         break;
-      }
+    }
+  }
+}
+
+void MinionEquipment::autoAssign(const vector<WConstCreature>& creatures, vector<WItem> possibleItems) {
+  sortByEquipmentValue(possibleItems);
+  EnumMap<EquipmentSlot, vector<WItem>> bySlot;
+  vector<WItem> other;
+  for (WItem it : possibleItems)
+    if (!getOwner(it)) {
+      if (it->canEquip())
+        bySlot[it->getEquipmentSlot()].push_back(it);
+      else
+        other.push_back(it);
+    }
+  for (WConstCreature creature : creatures) {
+    auto slots = getEquippedSlots(creature);
+    for (auto slot : ENUM_ALL(EquipmentSlot))
+      if (!bySlot[slot].empty())
+        assignFirstNeeded(creature, bySlot[slot], slots);
+    assignFirstNeeded(creature, other, slots);
   }
 }
 
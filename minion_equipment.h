@@ -42,9 +42,13 @@ class MinionEquipment {
   bool isLocked(WConstCreature, UniqueEntity<Item>::Id) const;
   void sortByEquipmentValue(vector<WItem>& items) const;
   void autoAssign(WConstCreature, vector<WItem> possibleItems);
+  /** Assigns items to all the creatures in a single pass. The items are sorted only once and bucketed
+      by equipment slot, so each creature only looks at the slots that it can still fill.*/
+  void autoAssign(const vector<WConstCreature>&, vector<WItem> possibleItems);
   void updateItems(const vector<WItem>& items);
 
   private:
+  friend class Test;
   enum EquipmentType { ARMOR, HEALING, ARCHERY, COMBAT_ITEM };
 
   static optional<EquipmentType> getEquipmentType(const WItem it);
@@ -52,6 +56,10 @@ class MinionEquipment {
   bool isItemAppropriate(WConstCreature, const WItem) const;
   WItem getWorstItem(WConstCreature, vector<WItem>) const;
   int getItemValue(const WItem) const;
+  typedef map<EquipmentSlot, vector<WItem>> SlotItems;
+  SlotItems getEquippedSlots(WConstCreature) const;
+  bool tryToAssign(WConstCreature, WItem, SlotItems&);
+  void assignFirstNeeded(WConstCreature, vector<WItem>& sortedItems, SlotItems&);
 
   EntityMap<Item, UniqueEntity<Creature>::Id> SERIAL(owners);
   EntityMap<Creature, vector<WItem>> SERIAL(myItems);
@@ -28,7 +28,7 @@ static optional<Position> getRandomCloseTile(Position from, const vector<Positio
 }
 
 static optional<Position> getTileToExplore(WConstCollective collective, WConstCreature c, MinionTask task) {
-  vector<Position> border = Random.permutation(collective->getKnownTiles().getBorderTiles());
+  vector<Position> border = Random.permutation(asVector<Position>(collective->getKnownTiles().getBorderTiles()));
   switch (task) {
     case MinionTask::EXPLORE_CAVES:
       if (auto pos = getRandomCloseTile(c->getPosition(), border,
@@ -125,9 +125,9 @@ PTask MinionTasks::generate(WCollective collective, WCreature c, MinionTask task
         return Task::copulate(collective, target, 20);
       break;
     case MinionTaskInfo::EAT: {
-      const set<Position>& hatchery = collective->getConstructions().getBuiltPositions(FurnitureType::PIGSTY);
+      const PositionSet& hatchery = collective->getConstructions().getBuiltPositions(FurnitureType::PIGSTY);
       if (!hatchery.empty())
-        return Task::eat(hatchery);
+        return Task::eat(set<Position>(hatchery.begin(), hatchery.end()));
       break;
       }
     case MinionTaskInfo::SPIDER: {
@@ -48,6 +48,7 @@
 #include "item.h"
 #include "external_enemies.h"
 #include "tutorial.h"
+#include "field_of_view.h"
 #include "villain_type.h"
 #include "player_control.h"
 #include "tutorial.h"
@@ -92,6 +93,13 @@ void Model::updateSunlightMovement() {
     l->updateSunlightMovement();
 }
 
+void Model::rebuildLevelCaches() {
+  for (PLevel& l : levels)
+    l->rebuildCaches();
+  if (cemetery)
+    cemetery->rebuildCaches();
+}
+
 void Model::checkCreatureConsistency() {
   EntitySet<Creature> tmp;
   for (WCreature c : timeQueue->getAllCreatures()) {
@@ -104,6 +112,12 @@ void Model::checkCreatureConsistency() {
   }
 }
 
+const static double dormantTurns = 5;
+const static int minIdleMoves = 20;
+const static int idleRadius = 3;
+// Observers must not be able to come into sight of a dormant creature before it's checked again.
+const static int observerRange = FieldOfView::sightRange + 2 * dormantTurns;
+
 void Model::update(double totalTime) {
   if (WCreature creature = timeQueue->getNextCreature()) {
     CHECK(creature->getLevel() != nullptr) << "Creature misplaced before processing: " << creature->getName().bare() <<
@@ -121,8 +135,22 @@ void Model::update(double totalTime) {
     }
     CHECK(creature->getLevel() != nullptr) << "Creature misplaced before moving: " << creature->getName().bare() <<
         ". Any idea why this happened?";
-    if (!creature->isDead())
-      creature->makeMove();
+    if (!creature->isDead()) {
+      if (isDormant(creature)) {
+        idleStates.at(creature->getUniqueId()).dormant = true;
+        increaseLocalTime(creature, dormantTurns);
+      } else {
+        eventGenerator->startBatch();
+        try {
+          creature->makeMove();
+        } catch (...) {
+          eventGenerator->flushBatch();
+          throw;
+        }
+        eventGenerator->flushBatch();
+        updateIdleState(creature);
+      }
+    }
     CHECK(creature->getLevel() != nullptr) << "Creature misplaced after moving: " << creature->getName().bare() <<
         ". Any idea why this happened?";
     if (!creature->isDead() && creature->getLevel()->getModel() == this)
@@ -131,7 +159,63 @@ void Model::update(double totalTime) {
     currentTime = totalTime;
 }
 
+void Model::updateObservers() {
+  observers.clear();
+  if (game) {
+    if (WCreature player = game->getPlayer())
+      observers.push_back(player->getPosition());
+    if (WCollective col = game->getPlayerCollective())
+      for (WCreature c : col->getCreatures())
+        observers.push_back(c->getPosition());
+  }
+}
+
+void Model::updateIdleState(WCreature c) {
+  if (c->isDead() || c->getPosition().getModel() != this) {
+    idleStates.erase(c->getUniqueId());
+    return;
+  }
+  auto& state = idleStates[c->getUniqueId()];
+  state.dormant = false;
+  if (state.anchor && state.anchor->dist8(c->getPosition()) <= idleRadius)
+    ++state.numMoves;
+  else {
+    state.anchor = c->getPosition();
+    state.numMoves = 0;
+  }
+}
+
+bool Model::isDormant(WConstCreature c) const {
+  auto state = getReferenceMaybe(idleStates, c->getUniqueId());
+  if (!state || state->numMoves < minIdleMoves || c->isPlayer() || !c->getVisibleEnemies().empty())
+    return false;
+  Position pos = c->getPosition();
+  for (auto& observer : observers)
+    if (observer.dist8(pos) <= observerRange)
+      return false;
+  for (auto& col : collectives)
+    if (col->hasTask(c))
+      return false;
+  return true;
+}
+
+void Model::wakeUpCreature(WCreature c) {
+  auto it = idleStates.find(c->getUniqueId());
+  if (it == idleStates.end())
+    return;
+  if (!it->second.dormant) {
+    // Creatures that are awake keep their turn, only the idle count starts over.
+    it->second.numMoves = 0;
+    return;
+  }
+  idleStates.erase(it);
+  double time = timeQueue->getTime(c);
+  if (time > currentTime + 1)
+    timeQueue->increaseTime(c, currentTime + 1 - time);
+}
+
 void Model::tick(double time) {
+  updateObservers();
   for (WCreature c : timeQueue->getAllCreatures()) {
     c->tick();
   }
@@ -255,6 +339,7 @@ WLevel Model::getTopLevel() const {
 }
 
 void Model::killCreature(WCreature c) {
+  idleStates.erase(c->getUniqueId());
   deadCreatures.push_back(timeQueue->removeCreature(c));
   cemetery->landCreature(cemetery->getAllPositions(), c);
 }
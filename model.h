@@ -75,7 +75,10 @@ class Model : public OwnedObject<Model> {
   int getSaveProgressCount() const;
 
   void killCreature(WCreature victim);
+  /** Brings a dormant creature back to full simulation, e.g. when it is attacked.*/
+  void wakeUpCreature(WCreature);
   void updateSunlightMovement();
+  void rebuildLevelCaches();
 
   optional<Position> getOtherPortal(Position) const;
   void registerPortal(Position);
@@ -125,5 +128,18 @@ class Model : public OwnedObject<Model> {
   void checkCreatureConsistency();
   HeapAllocated<optional<ExternalEnemies>> SERIAL(externalEnemies);
   vector<Position> SERIAL(portals);
+  // Creatures that have stayed in one place for a while, far from the player and without a task, are dormant.
+  // They skip their moves, and are only checked every few turns whether they need to wake up.
+  struct IdleState {
+    optional<Position> anchor;
+    int numMoves = 0;
+    // Set while the creature is skipping its moves, so its next turn may be up to dormantTurns away.
+    bool dormant = false;
+  };
+  unordered_map<UniqueEntity<Creature>::Id, IdleState, CustomHash<UniqueEntity<Creature>::Id>> idleStates;
+  vector<Position> observers;
+  void updateObservers();
+  void updateIdleState(WCreature);
+  bool isDormant(WConstCreature) const;
 };
 
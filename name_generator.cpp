@@ -80,6 +80,7 @@ void NameGenerator::init(const DirectoryPath& namesPath) {
 
 
 string NameGenerator::getNext() {
+  std::unique_lock<std::mutex> lock(mutex);
   CHECK(!names.empty());
   string ret = names.front();
   if (!oneName) {
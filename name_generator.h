@@ -49,5 +49,7 @@ class NameGenerator : public Singleton<NameGenerator, NameGeneratorId> {
   private:
   NameGenerator(vector<string> names, bool oneName = false);
   queue<string> names;
+  // Site models can be generated on a background thread while the menus run.
+  std::mutex mutex;
   bool oneName;
 };
@@ -0,0 +1,201 @@
+#include "stdafx.h"
+#include "parallel_gzstream.h"
+
+static const int outputBlockSize = 1 << 20;
+static const int dictionarySize = 1 << 15;
+static const int firstInputBlockSize = 1 << 16;
+static const int inputBlockSize = 1 << 20;
+static const int numPrefetchedBlocks = 4;
+
+struct ParallelGzOutputBuf::Block {
+  std::vector<char> input;
+  std::vector<char> dictionary;
+  bool last;
+  std::vector<char> output;
+  uLong crc;
+};
+
+void ParallelGzOutputBuf::compressBlock(Block& block) {
+  z_stream stream {};
+  CHECK(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+  if (!block.dictionary.empty())
+    CHECK(deflateSetDictionary(&stream, (const Bytef*) block.dictionary.data(), block.dictionary.size()) == Z_OK);
+  // Room for the empty stored block added by Z_SYNC_FLUSH.
+  block.output.resize(deflateBound(&stream, block.input.size()) + 16);
+  stream.next_in = (Bytef*) block.input.data();
+  stream.avail_in = block.input.size();
+  stream.next_out = (Bytef*) block.output.data();
+  stream.avail_out = block.output.size();
+  // Non-final blocks end with a sync flush, so they are byte aligned and can be concatenated.
+  int res = deflate(&stream, block.last ? Z_FINISH : Z_SYNC_FLUSH);
+  CHECK(res == (block.last ? Z_STREAM_END : Z_OK)) << res;
+  CHECK(stream.avail_in == 0);
+  block.output.resize(stream.total_out);
+  deflateEnd(&stream);
+  block.crc = crc32(0, (const Bytef*) block.input.data(), block.input.size());
+}
+
+static void writeLittleEndian(std::ofstream& file, uLong value) {
+  for (int i : Range(4))
+    file.put(char((value >> (8 * i)) & 0xff));
+}
+
+ParallelGzOutputBuf::ParallelGzOutputBuf(const char* path) : file(path, std::ios::binary), crc(crc32(0, nullptr, 0)) {
+  buffer.resize(outputBlockSize);
+  setp(buffer.data(), buffer.data() + buffer.size());
+  const char header[] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff'};
+  file.write(header, sizeof(header));
+  failed = file.fail();
+}
+
+ParallelGzOutputBuf::~ParallelGzOutputBuf() {
+  close();
+}
+
+bool ParallelGzOutputBuf::isOpen() const {
+  return file.is_open();
+}
+
+void ParallelGzOutputBuf::submitBlock(bool last) {
+  auto block = make_shared<Block>();
+  block->input.assign(pbase(), pptr());
+  block->dictionary = dictionary;
+  block->last = last;
+  totalSize += block->input.size();
+  int newDictionary = min<int>(dictionarySize, block->input.size());
+  if (dictionary.size() + newDictionary > dictionarySize)
+    dictionary.erase(dictionary.begin(), dictionary.begin() + dictionary.size() + newDictionary - dictionarySize);
+  dictionary.insert(dictionary.end(), block->input.end() - newDictionary, block->input.end());
+  setp(buffer.data(), buffer.data() + buffer.size());
+  if (pending.size() >= max<unsigned>(1, thread::hardware_concurrency()))
+    writeBlock();
+  pending.emplace_back(thread([block] { compressBlock(*block); }), block);
+}
+
+void ParallelGzOutputBuf::writeBlock() {
+  auto& front = pending.front();
+  front.first.join();
+  auto& block = *front.second;
+  if (!failed) {
+    file.write(block.output.data(), block.output.size());
+    failed = file.fail();
+  }
+  crc = crc32_combine(crc, block.crc, block.input.size());
+  pending.pop_front();
+}
+
+int ParallelGzOutputBuf::overflow(int c) {
+  if (closed || failed)
+    return EOF;
+  submitBlock(false);
+  if (failed)
+    return EOF;
+  if (c != EOF) {
+    *pptr() = c;
+    pbump(1);
+  }
+  return c == EOF ? 0 : c;
+}
+
+int ParallelGzOutputBuf::sync() {
+  // Blocks are only compressed once they're full, so there is nothing to flush early.
+  return failed ? -1 : 0;
+}
+
+bool ParallelGzOutputBuf::close() {
+  if (!closed) {
+    closed = true;
+    submitBlock(true);
+    while (!pending.empty())
+      writeBlock();
+    writeLittleEndian(file, crc);
+    writeLittleEndian(file, totalSize);
+    file.close();
+    failed = failed || file.fail();
+  }
+  return !failed;
+}
+
+PrefetchGzInputBuf::PrefetchGzInputBuf(const char* path) : file(gzopen(path, "rb")),
+    freeSlots(numPrefetchedBlocks), done(false) {
+  if (file)
+    gzbuffer(file, 1 << 17);
+  setg(nullptr, nullptr, nullptr);
+}
+
+PrefetchGzInputBuf::~PrefetchGzInputBuf() {
+  done = true;
+  if (reader.joinable()) {
+    freeSlots.v();
+    reader.join();
+  }
+  if (file)
+    gzclose(file);
+}
+
+bool PrefetchGzInputBuf::isOpen() const {
+  return !!file;
+}
+
+void PrefetchGzInputBuf::readLoop() {
+  while (true) {
+    freeSlots.p();
+    if (done)
+      return;
+    auto block = make_shared<std::vector<char>>(inputBlockSize);
+    int num = gzread(file, block->data(), block->size());
+    if (num <= 0) {
+      blocks.push(nullptr);
+      return;
+    }
+    block->resize(num);
+    blocks.push(block);
+  }
+}
+
+int PrefetchGzInputBuf::underflow() {
+  if (gptr() && gptr() < egptr())
+    return *reinterpret_cast<unsigned char*>(gptr());
+  if (!file || eof)
+    return EOF;
+  if (!eback()) {
+    current.resize(firstInputBlockSize);
+    int num = gzread(file, current.data(), current.size());
+    if (num <= 0) {
+      eof = true;
+      return EOF;
+    }
+    current.resize(num);
+  } else {
+    if (!reader.joinable())
+      reader = thread([this] { readLoop(); });
+    auto block = blocks.pop();
+    if (!block) {
+      eof = true;
+      return EOF;
+    }
+    freeSlots.v();
+    current = std::move(*block);
+  }
+  setg(current.data(), current.data(), current.data() + current.size());
+  return *reinterpret_cast<unsigned char*>(gptr());
+}
+
+ParallelGzOutput::ParallelGzOutput(const string& p) : std::ostream(nullptr), buf(p.c_str()), path(p) {
+  rdbuf(&buf);
+  if (!buf.isOpen())
+    setstate(std::ios::badbit);
+}
+
+void ParallelGzOutput::close() {
+  if (!buf.close()) {
+    setstate(std::ios::badbit);
+    throw std::ios::failure("Failed to write " + path);
+  }
+}
+
+PrefetchGzInput::PrefetchGzInput(const string& path) : std::istream(nullptr), buf(path.c_str()) {
+  rdbuf(&buf);
+  if (!buf.isOpen())
+    setstate(std::ios::badbit);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <zlib.h>
+
+#include "util.h"
+
+/** Gzip output stream for large saves. The data is collected in big blocks, which are deflated on
+    separate threads, each block primed with the end of the previous one as its dictionary.
+    The blocks are joined into a single, standard gzip stream.*/
+class ParallelGzOutputBuf : public std::streambuf {
+  public:
+  ParallelGzOutputBuf(const char* path);
+  ~ParallelGzOutputBuf();
+  bool isOpen() const;
+  /** Returns false if any part of the file failed to be written.*/
+  bool close();
+
+  protected:
+  virtual int overflow(int c) override;
+  virtual int sync() override;
+
+  private:
+  struct Block;
+  static void compressBlock(Block&);
+  void submitBlock(bool last);
+  void writeBlock();
+  std::ofstream file;
+  std::vector<char> buffer;
+  std::vector<char> dictionary;
+  std::deque<pair<thread, shared_ptr<Block>>> pending;
+  unsigned long crc;
+  unsigned long totalSize = 0;
+  bool closed = false;
+  bool failed = false;
+};
+
+/** Gzip input stream that decompresses ahead of the reader on a separate thread. The first small
+    block is read on the calling thread, so that peeking at a save's header doesn't read the whole file.*/
+class PrefetchGzInputBuf : public std::streambuf {
+  public:
+  PrefetchGzInputBuf(const char* path);
+  ~PrefetchGzInputBuf();
+  bool isOpen() const;
+
+  protected:
+  virtual int underflow() override;
+
+  private:
+  void readLoop();
+  gzFile file;
+  std::vector<char> current;
+  SyncQueue<shared_ptr<std::vector<char>>> blocks;
+  Semaphore freeSlots;
+  std::atomic<bool> done;
+  thread reader;
+  bool eof = false;
+};
+
+class ParallelGzOutput : public std::ostream {
+  public:
+  ParallelGzOutput(const string& path);
+  /** Writes out the remaining data and throws if the file couldn't be written completely. The destructor
+      closes the file too, but can't report errors.*/
+  void close();
+
+  private:
+  ParallelGzOutputBuf buf;
+  string path;
+};
+
+class PrefetchGzInput : public std::istream {
+  public:
+  PrefetchGzInput(const string& path);
+
+  private:
+  PrefetchGzInputBuf buf;
+};
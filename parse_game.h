@@ -3,10 +3,14 @@
 #include "util.h"
 #include "saved_game_info.h"
 #include "gzstream.h"
+#include "parallel_gzstream.h"
 #include "file_path.h"
 
 typedef StreamCombiner<ogzstream, OutputArchive> CompressedOutput;
 typedef StreamCombiner<igzstream, InputArchive> CompressedInput;
+// Same format as above, for whole game saves. Compresses on many threads and decompresses ahead of the reader.
+typedef StreamCombiner<ParallelGzOutput, OutputArchive> ParallelCompressedOutput;
+typedef StreamCombiner<PrefetchGzInput, InputArchive> PrefetchCompressedInput;
 
 template <typename InputType>
 optional<pair<string, int>> getNameAndVersionUsing(const FilePath& filename) {
@@ -564,7 +564,8 @@ vector<Player::CommandInfo> Player::getCommands() const {
 
 void Player::makeMove() {
   if (!isSubscribed())
-    subscribeTo(getCreature()->getPosition().getModel());
+    subscribeTo(getCreature()->getPosition().getModel(), {EventId::MOVED, EventId::ITEMS_THROWN, EventId::EXPLOSION,
+        EventId::ALARM, EventId::CONQUERED_ENEMY, EventId::WON_GAME});
   if (adventurer)
     considerAdventurerMusic();
   if (currentTimePos && currentTimePos->pos.getLevel() != getCreature()->getLevel()) {
@@ -1025,7 +1026,7 @@ vector<Vec2> Player::getUnknownLocations(WConstLevel level) const {
   for (auto col : getCreature()->getPosition().getModel()->getCollectives())
     if (col->getLevel() == getLevel())
       if (auto& pos = col->getTerritory().getCentralPoint())
-        if (!getMemory().getViewIndex(*pos))
+        if (!getMemory().isRemembered(*pos))
           ret.push_back(pos->getCoord());
   return ret;
 }
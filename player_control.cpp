@@ -333,7 +333,8 @@ PlayerControl::PlayerControl(Private, WCollective col) : CollectiveControl(col),
 
 PPlayerControl PlayerControl::create(WCollective col) {
   auto ret = makeOwner<PlayerControl>(Private{}, col);
-  ret->subscribeTo(col->getLevel()->getModel());
+  ret->subscribeTo(col->getLevel()->getModel(), {EventId::POSITION_DISCOVERED, EventId::CREATURE_EVENT,
+      EventId::MOVED, EventId::EQUIPED, EventId::WON_GAME, EventId::TECHBOOK_READ});
   return ret;
 }
 
@@ -909,7 +910,7 @@ VillageInfo::Village PlayerControl::getVillageInfo(WConstCollective col) const {
 
 void PlayerControl::handleTrading(WCollective ally) {
   ScrollPosition scrollPos;
-  const set<Position>& storage = getCollective()->getZones().getPositions(ZoneId::STORAGE_EQUIPMENT);
+  const PositionSet& storage = getCollective()->getZones().getPositions(ZoneId::STORAGE_EQUIPMENT);
   if (storage.empty()) {
     getView()->presentText("Information", "You need a storage room for equipment in order to trade.");
     return;
@@ -930,7 +931,7 @@ void PlayerControl::handleTrading(WCollective ally) {
     for (WItem it : available)
       if (it->getUniqueId() == *index && it->getPrice() <= budget) {
         getCollective()->takeResource({ResourceId::GOLD, it->getPrice()});
-        Random.choose(storage).dropItem(ally->buyItem(it));
+        Random.choose(asVector<Position>(storage)).dropItem(ally->buyItem(it));
       }
     getView()->updateView(this, true);
   }
@@ -966,14 +967,14 @@ void PlayerControl::handlePillage(WCollective col) {
   while (1) {
     struct PillageOption {
       vector<WItem> items;
-      set<Position> storage;
+      vector<Position> storage;
     };
     vector<PillageOption> options;
     for (auto& elem : Item::stackItems(col->getAllItems(false)))
       if (auto storage = getCollective()->getStorageFor(elem.second.front()))
-        options.push_back({elem.second, *storage});
+        options.push_back({elem.second, asVector<Position>(*storage)});
       else
-        options.push_back({elem.second, getCollective()->getZones().getPositions(ZoneId::STORAGE_EQUIPMENT)});
+        options.push_back({elem.second, asVector<Position>(getCollective()->getZones().getPositions(ZoneId::STORAGE_EQUIPMENT))});
     if (options.empty())
       return;
     vector<ItemInfo> itemInfo = options.transform([] (const PillageOption& it) {
@@ -2309,11 +2310,11 @@ void PlayerControl::handleSelection(Vec2 pos, const BuildInfo& building, bool re
         }
     case BuildInfo::ZONE:
         if (getCollective()->getZones().isZone(position, building.zone) && selection != SELECT) {
-          getCollective()->getZones().eraseZone(position, building.zone);
+          getCollective()->eraseZone(position, building.zone);
           selection = DESELECT;
         } else if (selection != DESELECT && !getCollective()->getZones().isZone(position, building.zone) &&
             getCollective()->getKnownTiles().isKnown(position)) {
-          getCollective()->getZones().setZone(position, building.zone);
+          getCollective()->setZone(position, building.zone);
           selection = SELECT;
         }
         break;
@@ -2487,7 +2488,7 @@ void PlayerControl::update(bool currentlyActive) {
 
 bool PlayerControl::isConsideredAttacking(WConstCreature c, WConstCollective enemy) {
   if (enemy && enemy->getModel() == getModel())
-    return canSee(c) && getCollective()->getTerritory().getStandardExtended().contains(c->getPosition());
+    return canSee(c) && getCollective()->getTerritory().isStandardExtended(c->getPosition());
   else
     return canSee(c) && c->getLevel() == getLevel();
 }
@@ -16,36 +16,129 @@
 #include "stdafx.h"
 
 #include "poison_gas.h"
-#include "level.h"
 
-SERIALIZE_DEF(PoisonGas, amount)
+static const int blockSize = 16;
+static const float decrease = 0.98;
+static const float cardinalSpread = 0.125;
+static const float diagonalSpread = 0.0625;
+static const float minAmount = 0.01;
 
-void PoisonGas::addAmount(double a) {
-  CHECK(a > 0);
-  amount = min(1., a + amount);
+SERIALIZATION_CONSTRUCTOR_IMPL(PoisonGas)
+
+PoisonGas::PoisonGas(Rectangle b) : bounds(b), width(b.width() + 2),
+    numBlocksX((b.width() + blockSize - 1) / blockSize), numBlocksY((b.height() + blockSize - 1) / blockSize),
+    amount(width * (b.height() + 2), 0), next(amount.size(), 0), transparent(amount.size(), 0),
+    activeBlocks(numBlocksX * numBlocksY, 0) {
+  // The border of the grid stays opaque, so the stencil never needs bounds checks.
+  for (Vec2 v : bounds)
+    transparent[getIndex(v)] = 1;
 }
 
-const double decrease = 0.98;
-const double spread = 0.10;
+int PoisonGas::getIndex(Vec2 pos) const {
+  return (pos.y - bounds.top() + 1) * width + pos.x - bounds.left() + 1;
+}
 
-void PoisonGas::tick(Position pos) {
-  if (amount < 0.01) {
-    amount = 0;
-    return;
+int PoisonGas::getBlock(Vec2 pos) const {
+  return (pos.y - bounds.top()) / blockSize * numBlocksX + (pos.x - bounds.left()) / blockSize;
+}
+
+void PoisonGas::addAmount(Vec2 pos, double a) {
+  CHECK(a > 0);
+  int index = getIndex(pos);
+  if (transparent[index] > 0) {
+    amount[index] = min(1.0f, amount[index] + float(a));
+    activeBlocks[getBlock(pos)] = true;
   }
-  for (Position v : pos.neighbors8(Random)) {
-    if (v.canSeeThru(VisionId::NORMAL) && amount > 0 && v.getPoisonGasAmount() < amount) {
-      double transfer = pos.getDir(v).isCardinal4() ? spread : spread / 2;
-      transfer = min(amount, transfer);
-      transfer = min((amount - v.getPoisonGasAmount()) / 2, transfer);
-      amount -= transfer;
-      v.addPoisonGas(transfer);
+}
+
+double PoisonGas::getAmount(Vec2 pos) const {
+  return amount[getIndex(pos)];
+}
+
+void PoisonGas::setTransparent(Vec2 pos, bool state) {
+  int index = getIndex(pos);
+  transparent[index] = state ? 1 : 0;
+  if (!state)
+    amount[index] = 0;
+}
+
+void PoisonGas::diffuseBlock(int blockX, int blockY) {
+  int left = blockX * blockSize + 1;
+  int right = min(bounds.width(), (blockX + 1) * blockSize) + 1;
+  for (int y = blockY * blockSize + 1; y < min(bounds.height(), (blockY + 1) * blockSize) + 1; ++y) {
+    const float* up = amount.data() + (y - 1) * width;
+    const float* mid = amount.data() + y * width;
+    const float* down = amount.data() + (y + 1) * width;
+    const float* tUp = transparent.data() + (y - 1) * width;
+    const float* tMid = transparent.data() + y * width;
+    const float* tDown = transparent.data() + (y + 1) * width;
+    float* out = next.data() + y * width;
+    for (int x = left; x < right; ++x) {
+      float a = mid[x];
+      float flow = cardinalSpread * (tMid[x - 1] * (mid[x - 1] - a) + tMid[x + 1] * (mid[x + 1] - a) +
+              tUp[x] * (up[x] - a) + tDown[x] * (down[x] - a)) +
+          diagonalSpread * (tUp[x - 1] * (up[x - 1] - a) + tUp[x + 1] * (up[x + 1] - a) +
+              tDown[x - 1] * (down[x - 1] - a) + tDown[x + 1] * (down[x + 1] - a));
+      float value = tMid[x] * decrease * (a + flow);
+      out[x] = value < minAmount ? 0 : value;
     }
   }
-  amount = max(0.0, amount * decrease);
 }
 
-double PoisonGas::getAmount() const {
-  return amount;
+void PoisonGas::tick(function<void(Vec2, double)> changedFun) {
+  // Gas can only flow into the neighbors of the blocks that contain some.
+  std::vector<char> ticked(activeBlocks.size(), 0);
+  bool anyActive = false;
+  for (int by : Range(numBlocksY))
+    for (int bx : Range(numBlocksX))
+      if (activeBlocks[by * numBlocksX + bx]) {
+        anyActive = true;
+        for (int y : Range(max(0, by - 1), min(numBlocksY, by + 2)))
+          for (int x : Range(max(0, bx - 1), min(numBlocksX, bx + 2)))
+            ticked[y * numBlocksX + x] = true;
+      }
+  if (!anyActive)
+    return;
+  for (int by : Range(numBlocksY))
+    for (int bx : Range(numBlocksX))
+      if (ticked[by * numBlocksX + bx])
+        diffuseBlock(bx, by);
+  for (int by : Range(numBlocksY))
+    for (int bx : Range(numBlocksX))
+      if (ticked[by * numBlocksX + bx]) {
+        bool active = false;
+        Rectangle block(bounds.left() + bx * blockSize, bounds.top() + by * blockSize,
+            min(bounds.right(), bounds.left() + (bx + 1) * blockSize),
+            min(bounds.bottom(), bounds.top() + (by + 1) * blockSize));
+        for (Vec2 v : block) {
+          int index = getIndex(v);
+          if (amount[index] > 0 || next[index] > 0) {
+            amount[index] = next[index];
+            if (next[index] > 0)
+              active = true;
+            changedFun(v, next[index]);
+          }
+        }
+        activeBlocks[by * numBlocksX + bx] = active;
+      }
+}
+
+template <class Archive>
+void PoisonGas::serialize(Archive& ar, const unsigned int) {
+  // Only the tiles that contain gas are saved. The transparency mask is set up again by the Level.
+  vector<pair<Vec2, float>> SERIAL(tiles);
+  if (!Archive::is_loading::value)
+    for (Vec2 v : bounds)
+      if (amount[getIndex(v)] > 0)
+        tiles.push_back(make_pair(v, amount[getIndex(v)]));
+  ar(bounds, tiles);
+  if (Archive::is_loading::value) {
+    *this = PoisonGas(bounds);
+    for (auto& tile : tiles) {
+      amount[getIndex(tile.first)] = tile.second;
+      activeBlocks[getBlock(tile.first)] = true;
+    }
+  }
 }
 
+SERIALIZABLE(PoisonGas);
@@ -16,21 +16,33 @@
 #pragma once
 
 #include "util.h"
-#include "position.h"
-
-class Level;
 
+/** Poison gas of a whole Level. Amounts are kept in a padded float grid and diffused with a fixed
+    stencil, so that the inner loop can be vectorized. Only blocks of tiles that contain gas, and their
+    neighbors, are ticked. Tiles that can't be seen through are masked out and never hold any gas.*/
 class PoisonGas {
   public:
-  void addAmount(double amount);
-  void tick(Position);
-  double getAmount() const;
+  PoisonGas(Rectangle bounds);
+  void addAmount(Vec2, double amount);
+  double getAmount(Vec2) const;
+  void setTransparent(Vec2, bool);
+
+  /** Diffuses the gas by one turn. Calls the given function for every tile whose amount was or is positive.*/
+  void tick(function<void(Vec2, double)>);
 
-  template <class Archive> 
-  void serialize(Archive& ar, const unsigned int version);
+  SERIALIZATION_DECL(PoisonGas)
 
   private:
-  double SERIAL(amount) = 0;
+  int getIndex(Vec2) const;
+  int getBlock(Vec2) const;
+  void diffuseBlock(int blockX, int blockY);
+  Rectangle bounds;
+  int width;
+  int numBlocksX;
+  int numBlocksY;
+  std::vector<float> amount;
+  std::vector<float> next;
+  std::vector<float> transparent;
+  std::vector<char> activeBlocks;
 };
 
-
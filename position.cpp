@@ -20,6 +20,7 @@
 #include "movement_set.h"
 #include "furniture_array.h"
 #include "inventory.h"
+#include "poison_gas.h"
 
 SERIALIZE_DEF(Position, coord, level)
 SERIALIZATION_CONSTRUCTOR_IMPL(Position);
@@ -145,16 +146,11 @@ vector<WFurniture> Position::modFurniture() const {
 
 WCreature Position::getCreature() const {
   if (isValid())
-    return getSquare()->getCreature();
+    return level->creatureGrid[coord];
   else
     return nullptr;
 }
 
-void Position::removeCreature() {
-  CHECK(isValid());
-  modSquare()->removeCreature(*this);
-}
-
 bool Position::operator == (const Position& o) const {
   return coord == o.coord && level == o.level;
 }
@@ -278,6 +274,8 @@ string Position::getName() const {
 void Position::getViewIndex(ViewIndex& index, WConstCreature viewer) const {
   if (isValid()) {
     getSquare()->getViewIndex(index, viewer);
+    if (double gas = getPoisonGasAmount())
+      index.setHighlight(HighlightType::POISON_GAS, min(1.0, gas));
     if (isUnavailable())
       index.setHighlight(HighlightType::UNAVAILABLE);
     for (auto furniture : getFurniture())
@@ -358,13 +356,13 @@ bool Position::canEnterEmpty(WConstCreature c) const {
 bool Position::canEnterEmpty(const MovementType& t, optional<FurnitureLayer> ignore) const {
   if (isUnavailable())
     return false;
-  auto square = getSquare();
   bool result = true;
   for (auto furniture : getFurniture()) {
     if (ignore == furniture->getLayer())
       continue;
     bool canEnter =
-        furniture->getMovementSet().canEnter(t, level->covered[coord], square->isOnFire(), square->getForbiddenTribe());
+        furniture->getMovementSet().canEnter(t, level->covered[coord], level->onFire[coord],
+            level->forbiddenTribe[coord]);
     if (furniture->overridesMovement())
       return canEnter;
     else
@@ -480,16 +478,11 @@ bool Position::isBurning() const {
 
 void Position::updateMovement() {
   if (isValid()) {
-    if (isBurning()) {
-      if (!getSquare()->isOnFire()) {
-        modSquare()->setOnFire(true);
-        updateConnectivity();
-      }
-    } else
-      if (getSquare()->isOnFire()) {
-        modSquare()->setOnFire(false);
-        updateConnectivity();
-      }
+    bool burning = isBurning();
+    if (burning != level->onFire[coord]) {
+      level->onFire[coord] = burning;
+      updateConnectivity();
+    }
   }
 }
 
@@ -529,22 +522,32 @@ const ViewObject& Position::getViewObject() const {
 }
 
 void Position::forbidMovementForTribe(TribeId t) {
-  if (!isUnavailable())
-    modSquare()->forbidMovementForTribe(*this, t);
+  if (!isUnavailable()) {
+    CHECK(!level->forbiddenTribe[coord] || level->forbiddenTribe[coord] == t);
+    level->forbiddenTribe[coord] = t;
+    updateConnectivity();
+    setNeedsMemoryUpdate(true);
+    setNeedsRenderUpdate(true);
+  }
 }
 
 void Position::allowMovementForTribe(TribeId t) {
-  if (!isUnavailable())
-    modSquare()->allowMovementForTribe(*this, t);
+  if (!isUnavailable()) {
+    CHECK(!level->forbiddenTribe[coord] || level->forbiddenTribe[coord] == t);
+    level->forbiddenTribe[coord] = none;
+    updateConnectivity();
+    setNeedsMemoryUpdate(true);
+    setNeedsRenderUpdate(true);
+  }
 }
 
 bool Position::isTribeForbidden(TribeId t) const {
-  return isValid() && getSquare()->isTribeForbidden(t);
+  return isValid() && level->forbiddenTribe[coord] == t;
 }
 
 optional<TribeId> Position::getForbiddenTribe() const {
   if (isValid())
-    return getSquare()->getForbiddenTribe();
+    return level->forbiddenTribe[coord];
   else
     return none;
 }
@@ -557,13 +560,16 @@ vector<Position> Position::getVisibleTiles(VisionId vision) {
 }
 
 void Position::addPoisonGas(double amount) {
-  if (isValid())
-    modSquare()->addPoisonGas(*this, amount);
+  if (isValid()) {
+    level->poisonGas->addAmount(coord, amount);
+    setNeedsRenderUpdate(true);
+    level->setNeedsMemoryUpdate(coord, true);
+  }
 }
 
 double Position::getPoisonGasAmount() const {
   if (isValid())
-    return getSquare()->getPoisonGasAmount();
+    return level->poisonGas->getAmount(coord);
   else
     return 0;
 }
@@ -30,7 +30,6 @@ class Position {
   bool isSameModel(const Position&) const;
   Vec2 getDir(const Position&) const;
   WCreature getCreature() const;
-  void removeCreature();
   void putCreature(WCreature);
   string getName() const;
   Position withCoord(Vec2 newCoord) const;
@@ -7,6 +7,7 @@
 #include "view_object.h"
 #include "furniture_type.h"
 #include "furniture_layer.h"
+#include "map_memory.h"
 
 template <class T>
 PositionMap<T>::PositionMap(const T& def) : defaultVal(def) {
@@ -104,5 +105,5 @@ class Task;
 SERIALIZABLE_TMPL(PositionMap, WTask);
 SERIALIZABLE_TMPL(PositionMap, HighlightType);
 SERIALIZABLE_TMPL(PositionMap, vector<WTask>);
-SERIALIZABLE_TMPL(PositionMap, optional<ViewIndex>);
+SERIALIZABLE_TMPL(PositionMap, MapMemory::Tile);
 SERIALIZABLE_TMPL(PositionMap, EnumMap<FurnitureLayer, optional<FurnitureType>>);
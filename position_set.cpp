@@ -0,0 +1,177 @@
+#include "stdafx.h"
+#include "position_set.h"
+#include "level.h"
+
+template <class Archive>
+void PositionSet::serialize(Archive& ar, const unsigned int) {
+  if (!Archive::is_loading::value) {
+    updateBits();
+    compact();
+  }
+  ar(elems);
+  if (Archive::is_loading::value) {
+    numElems = elems.size();
+    // The levels might not be fully loaded yet, so the bitmaps are built on first use.
+    bitsValid = false;
+  }
+}
+
+SERIALIZABLE(PositionSet);
+
+PositionSet::LevelBits::LevelBits(Rectangle b) : bounds(b), member(b.width() * b.height()),
+    listed(b.width() * b.height()) {
+}
+
+int PositionSet::LevelBits::getIndex(Vec2 v) const {
+  return (v.y - bounds.top()) * bounds.width() + v.x - bounds.left();
+}
+
+const PositionSet::LevelBits* PositionSet::getBits(Position pos) const {
+  auto it = levels.find(pos.getLevel()->getUniqueId());
+  if (it != levels.end() && pos.getCoord().inRectangle(it->second.bounds))
+    return &it->second;
+  return nullptr;
+}
+
+PositionSet::LevelBits& PositionSet::getOrInitBits(Position pos) {
+  auto id = pos.getLevel()->getUniqueId();
+  auto it = levels.find(id);
+  if (it == levels.end())
+    it = levels.insert(make_pair(id, LevelBits(pos.getLevel()->getBounds().minusMargin(-20)))).first;
+  CHECK(pos.getCoord().inRectangle(it->second.bounds)) << "Position out of bounds " << pos.getCoord();
+  return it->second;
+}
+
+void PositionSet::rebuild() {
+  levels.clear();
+  auto oldElems = std::move(elems);
+  elems.clear();
+  numElems = 0;
+  bitsValid = true;
+  for (auto& pos : oldElems)
+    insert(pos);
+}
+
+void PositionSet::compact() {
+  if (elems.size() == numElems)
+    return;
+  vector<Position> newElems;
+  newElems.reserve(numElems);
+  for (auto& pos : elems) {
+    auto& bits = getOrInitBits(pos);
+    int index = bits.getIndex(pos.getCoord());
+    if (bits.member[index])
+      newElems.push_back(pos);
+    else
+      bits.listed[index] = false;
+  }
+  elems = std::move(newElems);
+}
+
+// The bitmaps are only missing right after loading, so this reallocates the elements before anything
+// could have started iterating over them.
+void PositionSet::updateBits() const {
+  if (!bitsValid)
+    const_cast<PositionSet*>(this)->rebuild();
+}
+
+bool PositionSet::isMember(Position pos) const {
+  if (auto bits = getBits(pos))
+    return bits->member[bits->getIndex(pos.getCoord())];
+  return false;
+}
+
+bool PositionSet::contains(Position pos) const {
+  updateBits();
+  return isMember(pos);
+}
+
+int PositionSet::count(Position pos) const {
+  return contains(pos) ? 1 : 0;
+}
+
+void PositionSet::insert(Position pos) {
+  if (!bitsValid)
+    rebuild();
+  auto& bits = getOrInitBits(pos);
+  int index = bits.getIndex(pos.getCoord());
+  if (!bits.member[index]) {
+    bits.member[index] = true;
+    ++numElems;
+    if (!bits.listed[index]) {
+      bits.listed[index] = true;
+      elems.push_back(pos);
+    }
+  }
+}
+
+void PositionSet::erase(Position pos) {
+  if (!bitsValid)
+    rebuild();
+  if (getBits(pos)) {
+    auto& bits = getOrInitBits(pos);
+    int index = bits.getIndex(pos.getCoord());
+    if (bits.member[index]) {
+      bits.member[index] = false;
+      --numElems;
+      if (elems.size() > 2 * numElems)
+        compact();
+    }
+  }
+}
+
+void PositionSet::clear() {
+  levels.clear();
+  elems.clear();
+  numElems = 0;
+  bitsValid = true;
+}
+
+int PositionSet::size() const {
+  return numElems;
+}
+
+bool PositionSet::empty() const {
+  return numElems == 0;
+}
+
+PositionSet::Iterator PositionSet::begin() const {
+  updateBits();
+  return Iterator(this, elems.begin());
+}
+
+PositionSet::Iterator PositionSet::end() const {
+  updateBits();
+  return Iterator(this, elems.end());
+}
+
+PositionSet::Iterator::Iterator(const PositionSet* s, vector<Position>::const_iterator i) : set(s), it(i) {
+  skipErased();
+}
+
+void PositionSet::Iterator::skipErased() {
+  while (it != set->elems.end() && !set->isMember(*it))
+    ++it;
+}
+
+const Position& PositionSet::Iterator::operator* () const {
+  return *it;
+}
+
+const Position* PositionSet::Iterator::operator -> () const {
+  return &*it;
+}
+
+PositionSet::Iterator& PositionSet::Iterator::operator ++ () {
+  ++it;
+  skipErased();
+  return *this;
+}
+
+bool PositionSet::Iterator::operator == (const Iterator& other) const {
+  return it == other.it;
+}
+
+bool PositionSet::Iterator::operator != (const Iterator& other) const {
+  return it != other.it;
+}
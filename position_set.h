@@ -0,0 +1,75 @@
+#pragma once
+
+#include "util.h"
+#include "position.h"
+
+/** A set of positions with a membership bitmap for every level that it has elements on. The elements
+    are also kept in a vector in the order they were inserted, so iterating doesn't chase tree nodes.
+    Erasing only clears the bit and iteration skips the erased elements. The vector is compacted by erase()
+    once most of it is erased, so like with a vector, insert() and erase() invalidate the iterators.*/
+class PositionSet {
+  public:
+  bool contains(Position) const;
+  int count(Position) const;
+  void insert(Position);
+  void erase(Position);
+  void clear();
+  int size() const;
+  bool empty() const;
+
+  class Iterator {
+    public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Position value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Position* pointer;
+    typedef const Position& reference;
+
+    Iterator(const PositionSet*, vector<Position>::const_iterator);
+    const Position& operator* () const;
+    const Position* operator -> () const;
+    Iterator& operator ++ ();
+    bool operator == (const Iterator&) const;
+    bool operator != (const Iterator&) const;
+
+    private:
+    void skipErased();
+    const PositionSet* set;
+    vector<Position>::const_iterator it;
+  };
+
+  Iterator begin() const;
+  Iterator end() const;
+
+  template <typename Fun>
+  auto transform(Fun fun) const {
+    vector<decltype(fun(std::declval<Position>()))> ret;
+    ret.reserve(size());
+    for (auto& pos : *this)
+      ret.push_back(fun(pos));
+    return ret;
+  }
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+  private:
+  struct LevelBits {
+    LevelBits(Rectangle);
+    int getIndex(Vec2) const;
+    Rectangle bounds;
+    std::vector<bool> member;
+    // Set as long as the position is in elems, even if it was erased since.
+    std::vector<bool> listed;
+  };
+  const LevelBits* getBits(Position) const;
+  LevelBits& getOrInitBits(Position);
+  bool isMember(Position) const;
+  void updateBits() const;
+  void compact();
+  void rebuild();
+  vector<Position> SERIAL(elems);
+  int numElems = 0;
+  map<LevelId, LevelBits> levels;
+  bool bitsValid = true;
+};
@@ -23,6 +23,7 @@
 #include "fontstash.h"
 #include "sdl_event_generator.h"
 #include "clock.h"
+#include "tile_atlas_cache.h"
 
 Color Color::WHITE(255, 255, 255);
 Color Color::YELLOW(250, 255, 0);
@@ -170,6 +171,27 @@ optional<SDL::GLenum> Texture::loadFromMaybe(SDL::SDL_Surface* imageOrig) {
   return none;
 }
 
+optional<SDL::GLenum> Texture::updateRegionMaybe(SDL::SDL_Surface* image, Rectangle region) {
+  CHECK(texId);
+  CHECK(Vec2(image->w, image->h) == realSize);
+  CHECK(image->format->BytesPerPixel == 4);
+  SDL::glBindTexture(GL_TEXTURE_2D, (*texId));
+  int mode = image->format->Rmask == 0x000000ff ? GL_RGBA : GL_BGRA;
+  SDL::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  SDL::glPixelStorei(GL_UNPACK_ROW_LENGTH, image->w);
+  SDL::glPixelStorei(GL_UNPACK_SKIP_PIXELS, region.left());
+  SDL::glPixelStorei(GL_UNPACK_SKIP_ROWS, region.top());
+  SDL::glTexSubImage2D(GL_TEXTURE_2D, 0, region.left(), region.top(), region.width(), region.height(), mode,
+      GL_UNSIGNED_BYTE, image->pixels);
+  SDL::glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  SDL::glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+  SDL::glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+  auto error = SDL::glGetError();
+  if (error != GL_NO_ERROR)
+    return error;
+  return none;
+}
+
 Texture::Texture(const FilePath& filename, int px, int py, int w, int h) : path(filename) {
   SDL::SDL_Surface* image = SDL::IMG_Load(path->getPath());
   CHECK(image) << SDL::IMG_GetError();
@@ -220,43 +242,59 @@ const Vec2& Texture::getSize() const {
   return size;
 }
 
-void Texture::addTexCoord(int x, int y) const {
-  SDL::glTexCoord2f((float)x / realSize.x, (float)y / realSize.y);
-}
-
 Texture::Texture() {
 }
-  
-void Texture::render(Vec2 a, Vec2 b, Vec2 p, Vec2 k, optional<Color> color, bool vFlip, bool hFlip) const {
-  if (vFlip)
-    swap(p.y, k.y);
-  if (hFlip)
-    swap(p.x, k.x);
-  SDL::glBindTexture(GL_TEXTURE_2D, (*texId));
-  checkOpenglError();
-  SDL::glEnable(GL_TEXTURE_2D);
-  SDL::glBegin(GL_QUADS);
-  if (color)
-    color->applyGl();
-  else
-    SDL::glColor3f(1, 1, 1);
-  addTexCoord(p.x, p.y);
-  SDL::glVertex2f(a.x, a.y);
-  addTexCoord(k.x, p.y);
-  SDL::glVertex2f(b.x, a.y);
-  addTexCoord(k.x, k.y);
-  SDL::glVertex2f(b.x, b.y);
-  addTexCoord(p.x, k.y);
-  SDL::glVertex2f(a.x, b.y);
-  SDL::glEnd();
-  SDL::glDisable(GL_TEXTURE_2D);
-  checkOpenglError();
-}
 
 static float sizeConv(int size) {
   return 1.15 * (float)size;
 }
 
+static const int maxTextLayouts = 5000;
+
+struct Renderer::TextLayout {
+  Vec2 size;
+  std::vector<sth_run_quad> quads;
+};
+
+bool Renderer::TextLayoutKey::operator == (const TextLayoutKey& o) const {
+  return font == o.font && size == o.size && text == o.text;
+}
+
+shared_ptr<const Renderer::TextLayout> Renderer::getTextLayout(const string& s, int size, FontId id) {
+  TextLayoutKey key {id, size, s};
+  auto it = textLayouts.find(key);
+  if (it != textLayouts.end()) {
+    it->second.lastUsed = ++textLayoutCounter;
+    return it->second.layout;
+  }
+  if (textLayouts.size() >= maxTextLayouts) {
+    std::vector<long long> times;
+    for (auto& elem : textLayouts)
+      times.push_back(elem.second.lastUsed);
+    auto median = times.begin() + times.size() / 2;
+    std::nth_element(times.begin(), median, times.end());
+    for (auto it = textLayouts.begin(); it != textLayouts.end();)
+      if (it->second.lastUsed < *median)
+        it = textLayouts.erase(it);
+      else
+        ++it;
+  }
+  int font = getFont(id);
+  float height;
+  sth_vmetrics(fontStash, font, sizeConv(size), nullptr, nullptr, &height);
+  auto layout = make_shared<TextLayout>();
+  // The quads are laid out on the baseline, so they only need to be moved by whole pixels when drawn.
+  float baseline = int(height) * 0.9;
+  float minx, maxx;
+  layout->quads.resize(s.size());
+  int num = sth_layout_text(fontStash, font, sizeConv(size), baseline, s.c_str(), layout->quads.data(),
+      layout->quads.size(), &minx, &maxx);
+  layout->quads.resize(min<int>(num, layout->quads.size()));
+  layout->size = Vec2(maxx - minx, height);
+  textLayouts[key] = CachedTextLayout{layout, ++textLayoutCounter};
+  return layout;
+}
+
 int Renderer::getTextLength(const string& s, int size, FontId font) {
   return getTextSize(s, size, font).x;
 }
@@ -264,12 +302,7 @@ int Renderer::getTextLength(const string& s, int size, FontId font) {
 Vec2 Renderer::getTextSize(const string& s, int size, FontId id) {
   if (s.empty())
     return Vec2(0, 0);
-  float minx, maxx, miny, maxy;
-  int font = getFont(id);
-  sth_dim_text(fontStash, font, sizeConv(size), s.c_str(), &minx, &miny, &maxx, &maxy);
-  float height;
-  sth_vmetrics(fontStash, font, sizeConv(size), nullptr, nullptr, &height);
-  return Vec2(maxx - minx, height);
+  return getTextLayout(s, size, id)->size;
 }
 
 int Renderer::getFont(Renderer::FontId id) {
@@ -283,30 +316,30 @@ int Renderer::getFont(Renderer::FontId id) {
 }
 
 void Renderer::drawText(FontId id, int size, Color color, int x, int y, const string& s, CenterType center) {
-  if (!s.empty())
-    addRenderElem([this, s, center, size, color, x, y, id] {
-        int ox = 0;
-        int oy = 0;
-        Vec2 dim = getTextSize(s, size, id);
-        switch (center) {
-          case HOR:
-            ox -= dim.x / 2;
-            break;
-          case VER:
-            oy -= dim.y / 2;
-            break;
-          case HOR_VER:
-            ox -= dim.x / 2;
-            oy -= dim.y / 2;
-            break;
-          default:
-            break;
-        }
+  if (!s.empty()) {
+    auto layout = getTextLayout(s, size, id);
+    Vec2 dim = layout->size;
+    switch (center) {
+      case HOR:
+        x -= dim.x / 2;
+        break;
+      case VER:
+        y -= dim.y / 2;
+        break;
+      case HOR_VER:
+        x -= dim.x / 2;
+        y -= dim.y / 2;
+        break;
+      default:
+        break;
+    }
+    addRenderElem([this, layout, color, x, y] {
         sth_begin_draw(fontStash);
         color.applyGl();
-        sth_draw_text(fontStash, getFont(id), sizeConv(size), ox + x, oy + y + (dim.y * 0.9), s.c_str(), nullptr);
+        sth_draw_run(fontStash, layout->quads.data(), layout->quads.size(), x, y);
         sth_end_draw(fontStash);
     });
+  }
 }
 
 void Renderer::drawText(Color color, int x, int y, const char* c, CenterType center, int size) {
@@ -330,9 +363,7 @@ void Renderer::drawTextWithHotkey(Color color, int x, int y, const string& text,
 
 void Renderer::drawImage(int px, int py, const Texture& image, double scale, optional<Color> color) {
   Vec2 p(px, py);
-  addRenderElem([p, &image, scale, color] {
-    image.render(p, p + image.getSize() * scale, Vec2(0, 0), image.getSize(), color);
-  });
+  addSprite(image, p, p + image.getSize() * scale, Vec2(0, 0), image.getSize(), color ? *color : Color::WHITE);
 }
 
 void Renderer::drawImage(Rectangle target, Rectangle source, const Texture& image) {
@@ -345,12 +376,26 @@ void Renderer::drawSprite(Vec2 pos, Vec2 stretchSize, const Texture& t) {
 
 void Renderer::drawSprite(Vec2 pos, Vec2 source, Vec2 size, const Texture& t, optional<Vec2> targetSize,
     optional<Color> color, bool vFlip, bool hFlip) {
-  addRenderElem([&t, pos, source, size, targetSize, color, vFlip, hFlip] {
-      if (targetSize)
-        t.render(pos, pos + *targetSize, source, source + size, color, vFlip, hFlip);
-      else
-        t.render(pos, pos + size, source, source + size, color, vFlip, hFlip);
-  });
+  Vec2 p = source;
+  Vec2 k = source + size;
+  if (vFlip)
+    swap(p.y, k.y);
+  if (hFlip)
+    swap(p.x, k.x);
+  addSprite(t, pos, pos + (targetSize ? *targetSize : size), p, k, color ? *color : Color::WHITE);
+}
+
+void Renderer::addSprite(const Texture& t, Vec2 a, Vec2 b, Vec2 p, Vec2 k, Color color) {
+  float pu = (float)p.x / t.realSize.x;
+  float pv = (float)p.y / t.realSize.y;
+  float ku = (float)k.x / t.realSize.x;
+  float kv = (float)k.y / t.realSize.y;
+  const SpriteBatch::Vertex quad[4] = {
+    {(float)a.x, (float)a.y, pu, pv, color.r, color.g, color.b, color.a},
+    {(float)b.x, (float)a.y, ku, pv, color.r, color.g, color.b, color.a},
+    {(float)b.x, (float)b.y, ku, kv, color.r, color.g, color.b, color.a},
+    {(float)a.x, (float)b.y, pu, kv, color.r, color.g, color.b, color.a}};
+  renderList[currentLayer].addQuad(*t.texId, currentLayer == 0 ? scissor : none, quad);
 }
 
 void Renderer::drawFilledRectangle(const Rectangle& t, Color color, optional<Color> outline) {
@@ -413,12 +458,7 @@ void Renderer::setGlScissor(optional<Rectangle> s) {
 }
 
 void Renderer::addRenderElem(function<void()> f) {
-  if (currentLayer == 0) {
-    auto thisScissor = scissor;
-    f = [f, thisScissor, this] { setGlScissor(thisScissor); f(); };
-  } else
-    f = [f, this] { setGlScissor(none); f(); };
-  renderList[currentLayer].push_back(f);
+  renderList[currentLayer].addCustom(currentLayer == 0 ? scissor : none, std::move(f));
 }
 
 void Renderer::setTopLayer() {
@@ -654,14 +694,14 @@ void Renderer::drawAsciiBackground(ViewId id, Rectangle bounds) {
     drawFilledRectangle(bounds, Color::BLACK);
 }
 
-bool Renderer::loadAltTilesFromDir(const DirectoryPath& path, Vec2 altSize) {
+bool Renderer::loadAltTilesFromDir(const DirectoryPath& path, Vec2 altSize, optional<FilePath> cache) {
   altTileSize.push_back(altSize);
-  return loadTilesFromDir(path, altTiles, altSize, 720 * altSize.x / tileSize.back().x);
+  return loadTilesFromDir(path, altTiles, altSize, 720 * altSize.x / tileSize.back().x, cache);
 }
 
-bool Renderer::loadTilesFromDir(const DirectoryPath& path, Vec2 size) {
+bool Renderer::loadTilesFromDir(const DirectoryPath& path, Vec2 size, optional<FilePath> cache) {
   tileSize.push_back(size);
-  return loadTilesFromDir(path, tiles, size, 720);
+  return loadTilesFromDir(path, tiles, size, 720, cache);
 }
 
 SDL::SDL_Surface* Renderer::createSurface(int w, int h) {
@@ -670,28 +710,73 @@ SDL::SDL_Surface* Renderer::createSurface(int w, int h) {
   return ret;
 }
 
-bool Renderer::loadTilesFromDir(const DirectoryPath& path, vector<Texture>& tiles, Vec2 size, int setWidth) {
+static void decodeTile(const FilePath& file, Vec2 size, SDL::SDL_PixelFormat* format, TileAtlasCache::Atlas& atlas,
+    Vec2 offset) {
+  SDL::SDL_Surface* im = SDL::IMG_Load(file.getPath());
+  CHECK(im) << file << ": "<< SDL::IMG_GetError();
+  CHECK(im->w == size.x && im->h == size.y) << file << " has wrong size " << im->w << " " << im->h;
+  SDL::SDL_Surface* converted = SDL::SDL_ConvertSurface(im, format, 0);
+  CHECK(converted) << file << ": " << SDL::SDL_GetError();
+  for (int y : Range(size.y))
+    memcpy(&atlas.pixels[(offset.y + y) * atlas.size.x + offset.x], (char*) converted->pixels + y * converted->pitch,
+        size.x * sizeof(std::uint32_t));
+  SDL::SDL_FreeSurface(converted);
+  SDL::SDL_FreeSurface(im);
+}
+
+// Every tile is copied to its own part of the atlas, so the images can be decoded on many threads at once.
+static TileAtlasCache::Atlas decodeTiles(const vector<FilePath>& files, Vec2 size, int setWidth) {
+  const static string imageSuf = ".png";
+  int rowLength = setWidth / size.x;
+  TileAtlasCache::Atlas ret;
+  ret.size = Vec2(setWidth, ((files.size() + rowLength - 1) / rowLength) * size.y);
+  ret.pixels.resize(ret.size.x * ret.size.y, 0);
+  for (auto& file : files) {
+    string fileName = file.getFileName();
+    ret.names.push_back(fileName.substr(0, fileName.size() - imageSuf.size()));
+  }
+  SDL::SDL_Surface* formatSurface = Renderer::createSurface(1, 1);
+  auto getOffset = [&] (int i) { return Vec2(size.x * (i % rowLength), size.y * (i / rowLength)); };
+  // The first image is decoded on this thread, so that the image library is initialized only once.
+  if (!files.empty())
+    decodeTile(files[0], size, formatSurface->format, ret, getOffset(0));
+  std::atomic<int> nextFile(1);
+  vector<thread> threads;
+  for (int i : Range(max(1, (int) thread::hardware_concurrency())))
+    threads.emplace_back([&] {
+      for (int index = nextFile++; index < files.size(); index = nextFile++)
+        decodeTile(files[index], size, formatSurface->format, ret, getOffset(index));
+    });
+  for (auto& t : threads)
+    t.join();
+  SDL::SDL_FreeSurface(formatSurface);
+  return ret;
+}
+
+bool Renderer::loadTilesFromDir(const DirectoryPath& path, vector<Texture>& tiles, Vec2 size, int setWidth,
+    optional<FilePath> cache) {
   const static string imageSuf = ".png";
   auto files = path.getFiles().filter([](const FilePath& f) { return f.hasSuffix(imageSuf);});
   int rowLength = setWidth / size.x;
-  SDL::SDL_Surface* image = createSurface(setWidth, ((files.size() + rowLength - 1) / rowLength) * size.y);
-  SDL::SDL_SetSurfaceBlendMode(image, SDL::SDL_BLENDMODE_NONE);
-  CHECK(image) << SDL::SDL_GetError();
-  for (int i : All(files)) {
-    SDL::SDL_Surface* im = SDL::IMG_Load(files[i].getPath());
-    SDL::SDL_SetSurfaceBlendMode(im, SDL::SDL_BLENDMODE_NONE);
-    CHECK(im) << files[i] << ": "<< SDL::IMG_GetError();
-    CHECK(im->w == size.x && im->h == size.y) << files[i] << " has wrong size " << im->w << " " << im->h;
-    SDL::SDL_Rect offset;
-    offset.x = size.x * (i % rowLength);
-    offset.y = size.y * (i / rowLength);
-    SDL_BlitSurface(im, nullptr, image, &offset);
-    string fileName = files[i].getFileName();
-    string spriteName = fileName.substr(0, fileName.size() - imageSuf.size());
+  optional<TileAtlasCache::Atlas> atlas;
+  std::uint64_t cacheKey = 0;
+  if (cache) {
+    cacheKey = TileAtlasCache::getKey(files, size, setWidth);
+    atlas = TileAtlasCache::load(*cache, cacheKey);
+  }
+  if (!atlas) {
+    atlas = decodeTiles(files, size, setWidth);
+    if (cache)
+      TileAtlasCache::save(*cache, cacheKey, *atlas);
+  }
+  for (int i : All(atlas->names)) {
+    auto& spriteName = atlas->names[i];
     CHECK(!tileCoords.count(spriteName)) << "Duplicate name " << spriteName;
     tileCoords[spriteName] = {{i % rowLength, i / rowLength}, int(tiles.size())};
-    SDL::SDL_FreeSurface(im);
   }
+  SDL::SDL_Surface* image = SDL::SDL_CreateRGBSurfaceFrom(atlas->pixels.data(), atlas->size.x, atlas->size.y, 32,
+      atlas->size.x * sizeof(std::uint32_t), 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+  CHECK(image) << SDL::SDL_GetError();
   tiles.push_back(Texture(image));
   SDL::SDL_FreeSurface(image);
   return true;
@@ -732,11 +817,35 @@ static void measureLatency() {
   SDL::glEnd();
 }
 
+void Renderer::drawBatch(const SpriteBatch& batch) {
+  auto& vertices = batch.getVertices();
+  for (auto& command : batch.getCommands()) {
+    setGlScissor(command.scissor);
+    if (command.texture) {
+      auto first = &vertices[command.firstVertex];
+      SDL::glBindTexture(GL_TEXTURE_2D, *command.texture);
+      SDL::glEnable(GL_TEXTURE_2D);
+      SDL::glEnableClientState(GL_VERTEX_ARRAY);
+      SDL::glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      SDL::glEnableClientState(GL_COLOR_ARRAY);
+      SDL::glVertexPointer(2, GL_FLOAT, sizeof(SpriteBatch::Vertex), &first->x);
+      SDL::glTexCoordPointer(2, GL_FLOAT, sizeof(SpriteBatch::Vertex), &first->u);
+      SDL::glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(SpriteBatch::Vertex), &first->r);
+      SDL::glDrawArrays(GL_QUADS, 0, command.numVertices);
+      SDL::glDisableClientState(GL_COLOR_ARRAY);
+      SDL::glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+      SDL::glDisableClientState(GL_VERTEX_ARRAY);
+      SDL::glDisable(GL_TEXTURE_2D);
+      checkOpenglError();
+    } else
+      command.custom();
+  }
+}
+
 void Renderer::drawAndClearBuffer() {
-  for (int i : All(renderList)) {
-    for (auto& elem : renderList[i])
-      elem();
-    renderList[i].clear();
+  for (auto& batch : renderList) {
+    drawBatch(batch);
+    batch.clear();
   }
   setGlScissor(none);
   SDL::SDL_GL_SwapWindow(window);
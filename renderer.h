@@ -18,6 +18,7 @@
 #include "sdl.h"
 #include "util.h"
 #include "file_path.h"
+#include "sprite_batch.h"
 
 
 struct Color : public SDL::SDL_Color {
@@ -85,6 +86,8 @@ class Texture {
   static optional<Texture> loadMaybe(const FilePath&);
 
   optional<SDL::GLenum> loadFromMaybe(SDL::SDL_Surface*);
+  /** Uploads only the given part of the surface, which must be the size of the texture.*/
+  optional<SDL::GLenum> updateRegionMaybe(SDL::SDL_Surface*, Rectangle);
   const Vec2& getSize() const;
 
   ~Texture();
@@ -92,9 +95,6 @@ class Texture {
   private:
   Texture();
   friend class Renderer;
-  void render(Vec2 screenP, Vec2 screenK, Vec2 srcP, Vec2 srck, optional<Color> = none,
-      bool vFlip = false, bool hFlip = false) const;
-  void addTexCoord(int x, int y) const;
   optional<SDL::GLuint> texId;
   Vec2 size;
   Vec2 realSize;
@@ -163,9 +163,11 @@ class Renderer {
   void drawQuads();
   static Color getBleedingColor(const ViewObject&);
   Vec2 getSize();
-  bool loadTilesFromDir(const DirectoryPath& path, Vec2 size);
-  bool loadTilesFromDir(const DirectoryPath&, vector<Texture>&, Vec2 size, int setWidth);
-  bool loadAltTilesFromDir(const DirectoryPath&, Vec2 altSize);
+  /** Loads all tiles from the directory into a single atlas. If a cache file is given, the atlas is read from
+      it when the tiles haven't changed, and written to it otherwise.*/
+  bool loadTilesFromDir(const DirectoryPath& path, Vec2 size, optional<FilePath> cache = none);
+  bool loadTilesFromDir(const DirectoryPath&, vector<Texture>&, Vec2 size, int setWidth, optional<FilePath> cache);
+  bool loadAltTilesFromDir(const DirectoryPath&, Vec2 altSize, optional<FilePath> cache = none);
 
   void drawAndClearBuffer();
   void resize(int width, int height);
@@ -210,10 +212,12 @@ class Renderer {
   deque<Event> eventQueue;
   bool genReleaseEvent = false;
   void addRenderElem(function<void()>);
+  void addSprite(const Texture&, Vec2 screenP, Vec2 screenK, Vec2 srcP, Vec2 srcK, Color);
+  void drawBatch(const SpriteBatch&);
   //sf::Text& getTextObject();
   stack<int> layerStack;
   int currentLayer = 0;
-  array<vector<function<void()>>, 2> renderList;
+  array<SpriteBatch, 2> renderList;
 //  vector<Vertex> quads;
   Vec2 mousePos;
   struct FontSet {
@@ -224,6 +228,23 @@ class Renderer {
   sth_stash* fontStash;
   void loadFonts(const DirectoryPath& fontPath, FontSet&);
   int getFont(Renderer::FontId);
+  struct TextLayout;
+  struct TextLayoutKey {
+    FontId font;
+    int size;
+    string text;
+    bool operator == (const TextLayoutKey&) const;
+    HASH_ALL(font, size, text)
+  };
+  struct CachedTextLayout {
+    shared_ptr<const TextLayout> layout;
+    long long lastUsed;
+  };
+  /** Measured size and glyph quads of recently drawn or measured strings. When it grows too big, the
+      half that was least recently used is evicted.*/
+  unordered_map<TextLayoutKey, CachedTextLayout, CustomHash<TextLayoutKey>> textLayouts;
+  long long textLayoutCounter = 0;
+  shared_ptr<const TextLayout> getTextLayout(const string&, int size, FontId);
   optional<thread::id> renderThreadId;
   bool fullscreen;
   int fullscreenMode;
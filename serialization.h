@@ -16,7 +16,6 @@
 #pragma once
 
 #include <cereal/cereal.hpp>
-#include <cereal/archives/binary.hpp>
 #include <cereal/types/deque.hpp>
 #include <cereal/types/set.hpp>
 #include <cereal/types/string.hpp>
@@ -35,12 +34,13 @@
 #include <cereal/types/bitset.hpp>
 #include <cereal/types/memory.hpp>
 #include "extern/variant_serialize.h"
+#include "flat_archive.h"
 
 #include "stdafx.h"
 #include "progress.h"
 
-typedef cereal::BinaryInputArchive InputArchive;
-typedef cereal::BinaryOutputArchive OutputArchive;
+typedef FlatInputArchive InputArchive;
+typedef FlatOutputArchive OutputArchive;
 
 #define SUBCLASS(X) cereal::base_class<X>(this)
 
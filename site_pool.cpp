@@ -0,0 +1,92 @@
+#include "stdafx.h"
+#include "site_pool.h"
+#include "campaign.h"
+#include "model.h"
+#include "model_builder.h"
+#include "enemy_factory.h"
+#include "progress.h"
+
+SitePool::SitePool(Options* o) : options(o) {
+}
+
+SitePool::~SitePool() {
+  stop();
+}
+
+bool SitePool::SiteType::operator == (const SiteType& t) const {
+  return enemyId == t.enemyId && villainType == t.villainType;
+}
+
+void SitePool::prefetch(const Campaign& campaign) {
+  vector<SiteType> wanted;
+  auto& sites = campaign.getSites();
+  for (Vec2 v : sites.getBounds())
+    if (auto villain = sites[v].getVillain())
+      // Sokoban levels come from a shared input file, so they are always generated on the spot.
+      if (villain->enemyId != EnemyId::SOKOBAN)
+        wanted.push_back(SiteType{villain->enemyId, villain->type});
+  std::unique_lock<std::mutex> lock(mutex);
+  vector<pair<SiteType, PModel>> kept;
+  for (auto& elem : ready)
+    if (wanted.removeElementMaybe(elem.first))
+      kept.push_back(std::move(elem));
+  ready = std::move(kept);
+  if (generating)
+    wanted.removeElementMaybe(*generating);
+  pending = wanted;
+  lock.unlock();
+  cond.notify_one();
+  if (!worker.joinable()) {
+    int seed = Random.get(1 << 30);
+    worker = thread([this, seed] { generateLoop(seed); });
+  }
+}
+
+void SitePool::generateLoop(int seed) {
+  Random.init(seed);
+  std::unique_lock<std::mutex> lock(mutex);
+  while (1) {
+    while (!stopping && pending.empty())
+      cond.wait(lock);
+    if (stopping)
+      return;
+    auto type = pending.back();
+    pending.pop_back();
+    generating = type;
+    lock.unlock();
+    PModel model;
+    try {
+      model = ModelBuilder(nullptr, Random, options, nullptr)
+          .campaignSiteModel("Campaign enemy site", type.enemyId, type.villainType);
+    } catch (Progress::InterruptedException) {
+      lock.lock();
+      generating = none;
+      return;
+    }
+    lock.lock();
+    generating = none;
+    ready.emplace_back(type, std::move(model));
+  }
+}
+
+void SitePool::stop() {
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cond.notify_one();
+  if (worker.joinable())
+    worker.join();
+  stopping = false;
+}
+
+PModel SitePool::take(EnemyId enemyId, VillainType villainType) {
+  std::unique_lock<std::mutex> lock(mutex);
+  for (int i : All(ready))
+    if (ready[i].first == SiteType{enemyId, villainType}) {
+      auto ret = std::move(ready[i].second);
+      ready.removeIndex(i);
+      return ret;
+    }
+  return nullptr;
+}
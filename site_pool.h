@@ -0,0 +1,40 @@
+#pragma once
+
+#include "util.h"
+#include "villain_type.h"
+
+class Campaign;
+class Options;
+
+/** Generates the villain sites of a campaign on a background thread while the player is still in the
+    campaign menu, so that embarking doesn't have to wait for them.*/
+class SitePool {
+  public:
+  SitePool(Options*);
+  ~SitePool();
+
+  /** Starts generating the villain sites of the campaign. Models that the campaign can't use are dropped.*/
+  void prefetch(const Campaign&);
+
+  /** Stops the background thread, waiting until the model that is being generated is done.*/
+  void stop();
+
+  /** Returns a model that was generated for the given villain, if there is one.*/
+  PModel take(EnemyId, VillainType);
+
+  private:
+  struct SiteType {
+    EnemyId enemyId;
+    VillainType villainType;
+    bool operator == (const SiteType&) const;
+  };
+  void generateLoop(int seed);
+  Options* options;
+  std::mutex mutex;
+  std::condition_variable cond;
+  vector<SiteType> pending;
+  optional<SiteType> generating;
+  vector<pair<SiteType, PModel>> ready;
+  bool stopping = false;
+  thread worker;
+};
@@ -0,0 +1,31 @@
+#include "stdafx.h"
+#include "sprite_batch.h"
+
+void SpriteBatch::addQuad(TextureId texture, const optional<Rectangle>& scissor, const Vertex (&quad)[4]) {
+  if (commands.empty() || commands.back().texture != texture || commands.back().scissor != scissor)
+    commands.push_back(Command{scissor, texture, vertices.size(), 0, nullptr});
+  for (auto& v : quad)
+    vertices.push_back(v);
+  commands.back().numVertices += 4;
+}
+
+void SpriteBatch::addCustom(const optional<Rectangle>& scissor, function<void()> f) {
+  commands.push_back(Command{scissor, none, vertices.size(), 0, std::move(f)});
+}
+
+void SpriteBatch::clear() {
+  commands.clear();
+  vertices.clear();
+}
+
+const vector<SpriteBatch::Command>& SpriteBatch::getCommands() const {
+  return commands;
+}
+
+const vector<SpriteBatch::Vertex>& SpriteBatch::getVertices() const {
+  return vertices;
+}
+
+int SpriteBatch::getNumDrawCalls() const {
+  return commands.size();
+}
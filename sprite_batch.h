@@ -0,0 +1,38 @@
+#pragma once
+
+#include "util.h"
+
+/** Typed command buffer for the Renderer. Consecutive sprites that use the same texture and scissor
+    are merged into a single draw call. Other drawing is kept as custom commands, which preserve
+    the drawing order, but break up the batches.*/
+class SpriteBatch {
+  public:
+  typedef unsigned TextureId;
+
+  struct Vertex {
+    float x, y;
+    float u, v;
+    unsigned char r, g, b, a;
+  };
+
+  struct Command {
+    optional<Rectangle> scissor;
+    // none for custom commands
+    optional<TextureId> texture;
+    int firstVertex;
+    int numVertices;
+    function<void()> custom;
+  };
+
+  void addQuad(TextureId, const optional<Rectangle>& scissor, const Vertex (&quad)[4]);
+  void addCustom(const optional<Rectangle>& scissor, function<void()>);
+  void clear();
+
+  const vector<Command>& getCommands() const;
+  const vector<Vertex>& getVertices() const;
+  int getNumDrawCalls() const;
+
+  private:
+  vector<Command> commands;
+  vector<Vertex> vertices;
+};
@@ -25,7 +25,6 @@
 #include "vision.h"
 #include "view_index.h"
 #include "inventory.h"
-#include "poison_gas.h"
 #include "tribe.h"
 #include "view.h"
 #include "event_listener.h"
@@ -33,10 +32,8 @@
 template <class Archive> 
 void Square::serialize(Archive& ar, const unsigned int version) { 
   ar & SUBCLASS(OwnedObject<Square>);
-  ar(inventory, onFire);
-  ar(creature, landingLink, poisonGas);
+  ar(inventory, landingLink);
   ar(lastViewer, viewIndex);
-  ar(forbiddenTribe);
   if (progressMeter)
     progressMeter->addProgress();
 }
@@ -51,13 +48,6 @@ Square::Square() : viewIndex(new ViewIndex()) {
 Square::~Square() {
 }
 
-void Square::putCreature(WCreature c) {
-  //CHECK(canEnter(c)) << c->getName().bare() << " " << getName();
-  setCreature(c);
-  onEnter(c);
-  if (WGame game = c->getGame())
-    game->addEvent({EventId::MOVED, c});
-}
 
 void Square::setLandingLink(StairKey key) {
   landingLink = key;
@@ -67,10 +57,6 @@ optional<StairKey> Square::getLandingLink() const {
   return landingLink;
 }
 
-void Square::setCreature(WCreature c) {
-  creature = c;
-}
-
 void Square::onAddedToLevel(Position pos) const {
   if (!inventory->isEmpty())
     pos.getLevel()->addTickingSquare(pos.getCoord());
@@ -88,14 +74,10 @@ void Square::tick(Position pos) {
     for (auto item : discarded)
       inventory->removeItem(item);
   }
-  poisonGas->tick(pos);
-  if (creature && poisonGas->getAmount() > 0.2) {
-    creature->poisonWithGas(min(1.0, poisonGas->getAmount()));
-  }
 }
 
-bool Square::itemLands(vector<WItem> item, const Attack& attack) const {
-  if (creature) {
+bool Square::itemLands(Position pos, vector<WItem> item, const Attack& attack) const {
+  if (WCreature creature = pos.getCreature()) {
     if (!creature->dodgeAttack(attack))
       return true;
     else {
@@ -112,7 +94,7 @@ bool Square::itemLands(vector<WItem> item, const Attack& attack) const {
 void Square::onItemLands(Position pos, vector<PItem> item, const Attack& attack, int remainingDist, Vec2 dir,
     VisionId vision) {
   setDirty(pos);
-  if (creature) {
+  if (WCreature creature = pos.getCreature()) {
     item[0]->onHitCreature(creature, attack, item.size());
     if (!item[0]->isDiscarded())
       dropItems(pos, std::move(item));
@@ -123,18 +105,6 @@ void Square::onItemLands(Position pos, vector<PItem> item, const Attack& attack,
     pos.dropItems(std::move(item));
 }
 
-void Square::addPoisonGas(Position pos, double amount) {
-  setDirty(pos);
-  if (pos.canSeeThru(VisionId::NORMAL)) {
-    poisonGas->addAmount(amount);
-    pos.getLevel()->addTickingSquare(pos.getCoord());
-  }
-}
-
-double Square::getPoisonGasAmount() const {
-  return poisonGas->getAmount();
-}
-
 void Square::getViewIndex(ViewIndex& ret, WConstCreature viewer) const {
   if ((!viewer && lastViewer) || (viewer && lastViewer == viewer->getUniqueId())) {
     ret = *viewIndex;
@@ -148,15 +118,9 @@ void Square::getViewIndex(ViewIndex& ret, WConstCreature viewer) const {
       fireSize = max(fireSize, it->getFireSize());
   if (WItem it = getTopItem())
     ret.insert(copyOf(it->getViewObject()).setAttribute(ViewObject::Attribute::BURNING, fireSize));
-  if (poisonGas->getAmount() > 0)
-    ret.setHighlight(HighlightType::POISON_GAS, min(1.0, poisonGas->getAmount()));
   *viewIndex = ret;
 }
 
-void Square::onEnter(WCreature c) {
-  setDirty(c->getPosition());
-}
-
 void Square::dropItem(Position pos, PItem item) {
   dropItems(pos, makeVec(std::move(item)));
 }
@@ -169,25 +133,7 @@ void Square::dropItems(Position pos, vector<PItem> items) {
   setDirty(pos);
   pos.getLevel()->addTickingSquare(pos.getCoord());
   dropItemsLevelGen(std::move(items));
-}
-
-WCreature Square::getCreature() const {
-  return creature;
-}
-
-bool Square::isOnFire() const {
-  return onFire;
-}
-
-void Square::setOnFire(bool state) {
-  onFire = state;
-}
-
-void Square::removeCreature(Position pos) {
-  setDirty(pos);
-  CHECK(creature);
-  WCreature tmp = creature;
-  creature = nullptr;
+  pos.getModel()->addEvent({EventId::INVENTORY_CHANGED, pos});
 }
 
 WItem Square::getTopItem() const {
@@ -211,12 +157,16 @@ const vector<WItem>& Square::getItems(ItemIndex index) const {
 
 PItem Square::removeItem(Position pos, WItem it) {
   setDirty(pos);
-  return getInventory().removeItem(it);
+  auto ret = getInventory().removeItem(it);
+  pos.getModel()->addEvent({EventId::INVENTORY_CHANGED, pos});
+  return ret;
 }
 
 vector<PItem> Square::removeItems(Position pos, vector<WItem> it) {
   setDirty(pos);
-  return getInventory().removeItems(it);
+  auto ret = getInventory().removeItems(it);
+  pos.getModel()->addEvent({EventId::INVENTORY_CHANGED, pos});
+  return ret;
 }
 
 void Square::setDirty(Position pos) {
@@ -225,28 +175,6 @@ void Square::setDirty(Position pos) {
   lastViewer.reset();
 }
 
-void Square::forbidMovementForTribe(Position pos, TribeId tribe) {
-  CHECK(!forbiddenTribe || forbiddenTribe == tribe);
-  forbiddenTribe = tribe;
-  pos.updateConnectivity();
-  setDirty(pos);
-}
-
-void Square::allowMovementForTribe(Position pos, TribeId tribe) {
-  CHECK(!forbiddenTribe || forbiddenTribe == tribe);
-  forbiddenTribe = none;
-  pos.updateConnectivity();
-  setDirty(pos);
-}
-
-bool Square::isTribeForbidden(TribeId tribe) const {
-  return forbiddenTribe == tribe;
-}
-
-optional<TribeId> Square::getForbiddenTribe() const {
-  return forbiddenTribe;
-}
-
 Inventory& Square::getInventory() {
   return *inventory;
 }
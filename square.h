@@ -23,7 +23,6 @@
 class Creature;
 class Item;
 class ProgressMeter;
-class PoisonGas;
 class Inventory;
 class Position;
 class ViewIndex;
@@ -44,30 +43,9 @@ class Square : public OwnedObject<Square> {
   /** Returns the entry point details. Returns none if square is not entry point. See setLandingLink().*/
   optional<StairKey> getLandingLink() const;
 
-  /** Adds some poison gas to the square.*/
-  void addPoisonGas(Position, double amount);
-
-  /** Returns the amount of poison gas on this square.*/
-  double getPoisonGasAmount() const;
-
   /** Sets the level this square is on.*/
   void onAddedToLevel(Position) const;
 
-  /** Puts a creature on the square.*/
-  void putCreature(WCreature);
-
-  /** Puts a creature on the square without triggering any mechanisms that happen when a creature enters.*/ 
-  void setCreature(WCreature);
-
-  /** Removes the creature from the square.*/
-  void removeCreature(Position);
-
-  /** Returns the creature from the square.*/
-  WCreature getCreature() const;
-
-  bool isOnFire() const;
-  void setOnFire(bool);
-
   //@{
   /** Drops item or items on the square. The square assumes ownership.*/
   void dropItem(Position, PItem);
@@ -81,7 +59,7 @@ class Square : public OwnedObject<Square> {
 
   void getViewIndex(ViewIndex&, WConstCreature viewer) const;
 
-  bool itemLands(vector<WItem> item, const Attack& attack) const;
+  bool itemLands(Position, vector<WItem> item, const Attack& attack) const;
   void onItemLands(Position, vector<PItem>, const Attack&, int remainingDist, Vec2 dir, VisionId);
   const vector<WItem>& getItems() const;
   vector<WItem> getItems(function<bool (WItem)> predicate) const;
@@ -89,11 +67,6 @@ class Square : public OwnedObject<Square> {
   PItem removeItem(Position, WItem);
   vector<PItem> removeItems(Position, vector<WItem>);
 
-  void forbidMovementForTribe(Position, TribeId);
-  void allowMovementForTribe(Position, TribeId);
-  bool isTribeForbidden(TribeId) const;
-  optional<TribeId> getForbiddenTribe() const;
- 
   ~Square();
 
   bool needsMemoryUpdate() const;
@@ -105,19 +78,13 @@ class Square : public OwnedObject<Square> {
   Inventory& getInventory();
   const Inventory& getInventory() const;
 
-  void onEnter(WCreature);
-
   template <class Archive>
   void serialize(Archive&, const unsigned int);
 
   private:
   WItem getTopItem() const;
   HeapAllocated<Inventory> SERIAL(inventory);
-  WCreature SERIAL(creature) = nullptr;
   optional<StairKey> SERIAL(landingLink);
-  HeapAllocated<PoisonGas> SERIAL(poisonGas);
   mutable optional<UniqueEntity<Creature>::Id> SERIAL(lastViewer);
   unique_ptr<ViewIndex> SERIAL(viewIndex);
-  optional<TribeId> SERIAL(forbiddenTribe);
-  bool SERIAL(onFire) = false;
 };
@@ -46,7 +46,7 @@ class Task : public UniqueEntity<Task>, public OwnedObject<Task> {
 
   static PTask construction(WTaskCallback, Position, FurnitureType);
   static PTask destruction(WTaskCallback, Position, WConstFurniture, DestroyAction);
-  static PTask bringItem(WTaskCallback, Position position, vector<WItem>, const set<Position>& target,
+  static PTask bringItem(WTaskCallback, Position position, vector<WItem>, vector<Position> target,
       int numRetries = 10);
   static PTask applyItem(WTaskCallback, Position, WItem, Position target);
   enum SearchType { LAZY, RANDOM_CLOSE };
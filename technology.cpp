@@ -162,7 +162,7 @@ static vector<Vec2> cutShape(Rectangle rect) {
 
 
 static void addResource(WCollective col, FurnitureType type, int maxDist) {
-  Position init = Random.choose(col->getConstructions().getBuiltPositions(FurnitureType::BOOKCASE));
+  Position init = Random.choose(asVector<Position>(col->getConstructions().getBuiltPositions(FurnitureType::BOOKCASE)));
   Rectangle resourceArea(Random.get(4, 7), Random.get(4, 7));
   resourceArea.translate(-resourceArea.middle());
   for (int t = 0; t < 200; ++t) {
@@ -2,25 +2,171 @@
 #include "territory.h"
 #include "position.h"
 #include "movement_type.h"
+#include "level.h"
 
-SERIALIZE_DEF(Territory, allSquares, allSquaresVec, centralPoint)
+// Tiles in the territory have distance 1, tiles further than this aren't tracked.
+static const int maxExtendedRadius = 20;
+static const int standardExtendedMin = 2;
+static const int standardExtendedMax = 10;
+static const std::uint8_t listedFlag = 0x80;
+
+template <class Archive>
+void Territory::serialize(Archive& ar, const unsigned int) {
+  ar(allSquaresVec, centralPoint);
+  if (Archive::is_loading::value)
+    // The levels might not be fully loaded yet, so the tables are rebuilt on first use.
+    tablesValid = false;
+}
+
+SERIALIZABLE(Territory);
+
+Territory::LevelTiles::LevelTiles(Rectangle bounds)
+    : territoryIndex(bounds, -1), distance(bounds, 0) {
+}
 
 void Territory::clearCache() {
   extendedCache.clear();
   extendedCache2.clear();
 }
 
+const Territory::LevelTiles* Territory::getTiles(Position pos) const {
+  auto it = levels.find(pos.getLevel()->getUniqueId());
+  if (it != levels.end() && pos.getCoord().inRectangle(it->second.distance.getBounds()))
+    return &it->second;
+  return nullptr;
+}
+
+Territory::LevelTiles& Territory::getOrInitTiles(Position pos) {
+  auto id = pos.getLevel()->getUniqueId();
+  auto it = levels.find(id);
+  if (it == levels.end())
+    it = levels.insert(make_pair(id, LevelTiles(pos.getLevel()->getBounds()))).first;
+  return it->second;
+}
+
+int Territory::getDistance(Position pos) const {
+  if (auto tiles = getTiles(pos))
+    return tiles->distance[pos.getCoord()] & ~listedFlag;
+  return 0;
+}
+
+// Tiles that lose their distance stay in the reached list until it's compacted.
+void Territory::setDistance(Position pos, int value) {
+  auto& elem = getOrInitTiles(pos).distance[pos.getCoord()];
+  bool listed = elem & listedFlag;
+  int previous = elem & ~listedFlag;
+  if (value > 0 && previous == 0)
+    ++numReached;
+  else if (value == 0 && previous > 0)
+    --numReached;
+  if (value > 0 && !listed) {
+    reached.push_back(pos);
+    listed = true;
+  }
+  elem = std::uint8_t(value | (listed ? listedFlag : 0));
+}
+
+void Territory::compactReached() {
+  int j = 0;
+  for (int i : All(reached)) {
+    Position pos = reached[i];
+    if (getDistance(pos) > 0)
+      reached[j++] = pos;
+    else
+      getOrInitTiles(pos).distance[pos.getCoord()] = 0;
+  }
+  reached.resize(j);
+}
+
+bool Territory::canExtendTo(Position pos) const {
+  auto tiles = getTiles(pos);
+  return tiles && tiles->territoryIndex[pos.getCoord()] == -1 && pos.canEnterEmpty({MovementTrait::WALK});
+}
+
+// Lowers distances, starting with the tiles in the buckets. Tiles in bucket i that no longer have distance i are skipped.
+void Territory::propagate(vector<vector<Position>>& buckets) {
+  for (int dist = 1; dist < maxExtendedRadius; ++dist)
+    for (int i = 0; i < buckets[dist].size(); ++i) {
+      Position pos = buckets[dist][i];
+      if (getDistance(pos) != dist)
+        continue;
+      for (Position v : pos.neighbors8())
+        if (canExtendTo(v)) {
+          int current = getDistance(v);
+          if (current == 0 || current > dist + 1) {
+            setDistance(v, dist + 1);
+            buckets[dist + 1].push_back(v);
+          }
+        }
+    }
+}
+
+void Territory::rebuildTables() {
+  levels.clear();
+  reached.clear();
+  numReached = 0;
+  vector<vector<Position>> buckets(maxExtendedRadius + 1);
+  for (int i : All(allSquaresVec)) {
+    Position pos = allSquaresVec[i];
+    getOrInitTiles(pos).territoryIndex[pos.getCoord()] = i;
+    setDistance(pos, 1);
+    buckets[1].push_back(pos);
+  }
+  propagate(buckets);
+  tablesValid = true;
+}
+
+void Territory::updateTables() const {
+  if (!tablesValid)
+    const_cast<Territory*>(this)->rebuildTables();
+}
+
 void Territory::insert(Position pos) {
-  if (!allSquares.count(pos)) {
+  updateTables();
+  if (!contains(pos)) {
+    getOrInitTiles(pos).territoryIndex[pos.getCoord()] = allSquaresVec.size();
     allSquaresVec.push_back(pos);
-    allSquares.insert(pos);
+    setDistance(pos, 1);
+    vector<vector<Position>> buckets(maxExtendedRadius + 1);
+    buckets[1].push_back(pos);
+    propagate(buckets);
     clearCache();
   }
 }
 
 void Territory::remove(Position pos) {
-  allSquaresVec.removeElement(pos);
-  allSquares.erase(pos);
+  updateTables();
+  if (!contains(pos))
+    return;
+  auto& tiles = getOrInitTiles(pos);
+  int index = tiles.territoryIndex[pos.getCoord()];
+  Position last = allSquaresVec.back();
+  getOrInitTiles(last).territoryIndex[last.getCoord()] = index;
+  allSquaresVec[index] = last;
+  allSquaresVec.pop_back();
+  tiles.territoryIndex[pos.getCoord()] = -1;
+  // Every tile whose distance might have gone up is reached from the removed one by steps that increase
+  // the distance by one. They are all cleared and filled in again from the tiles around them.
+  vector<pair<Position, int>> affected {{pos, 1}};
+  setDistance(pos, 0);
+  for (int i = 0; i < affected.size(); ++i) {
+    auto elem = affected[i];
+    for (Position v : elem.first.neighbors8())
+      if (getDistance(v) == elem.second + 1) {
+        setDistance(v, 0);
+        affected.push_back(make_pair(v, elem.second + 1));
+      }
+  }
+  vector<vector<Position>> buckets(maxExtendedRadius + 1);
+  for (auto& elem : affected)
+    for (Position v : elem.first.neighbors8()) {
+      int dist = getDistance(v);
+      if (dist > 0 && dist < maxExtendedRadius)
+        buckets[dist].push_back(v);
+    }
+  propagate(buckets);
+  if (int(reached.size()) > 2 * numReached)
+    compactReached();
   clearCache();
 }
 
@@ -29,7 +175,10 @@ void Territory::setCentralPoint(Position pos) {
 }
   
 bool Territory::contains(Position pos) const {
-  return allSquares.count(pos);
+  updateTables();
+  if (auto tiles = getTiles(pos))
+    return tiles->territoryIndex[pos.getCoord()] > -1;
+  return false;
 }
 
 const vector<Position>& Territory::getAll() const {
@@ -37,31 +186,28 @@ const vector<Position>& Territory::getAll() const {
 }
 
 vector<Position> Territory::calculateExtended(int minRadius, int maxRadius) const {
-  map<Position, int> extendedTiles;
-  vector<Position> extendedQueue;
-  for (Position pos : allSquaresVec) {
-    if (!extendedTiles.count(pos))  {
-      extendedTiles[pos] = 1;
-      extendedQueue.push_back(pos);
-    }
+  CHECK(maxRadius <= maxExtendedRadius) << maxRadius;
+  updateTables();
+  vector<vector<Position>> rings(maxRadius + 1);
+  for (Position pos : reached) {
+    int dist = getDistance(pos);
+    if (dist > 0 && dist >= minRadius && dist <= maxRadius)
+      rings[dist].push_back(pos);
   }
-  for (int i = 0; i < extendedQueue.size(); ++i) {
-    Position pos = extendedQueue[i];
-    for (Position v : pos.neighbors8())
-      if (!contains(v) && !extendedTiles.count(v) 
-          && v.canEnterEmpty({MovementTrait::WALK})) {
-        int a = extendedTiles[v] = extendedTiles[pos] + 1;
-        if (a < maxRadius)
-          extendedQueue.push_back(v);
-      }
-  }
-  if (minRadius > 0)
-    return extendedQueue.filter([&] (const Position& v) { return extendedTiles.at(v) >= minRadius; });
-  return extendedQueue;
+  vector<Position> ret;
+  for (auto& ring : rings)
+    ret.append(std::move(ring));
+  return ret;
 }
 
 const vector<Position>& Territory::getStandardExtended() const {
-  return getExtended(2, 10);
+  return getExtended(standardExtendedMin, standardExtendedMax);
+}
+
+bool Territory::isStandardExtended(Position pos) const {
+  updateTables();
+  int dist = getDistance(pos);
+  return dist >= standardExtendedMin && dist <= standardExtendedMax;
 }
 
 const vector<Position>& Territory::getExtended(int min, int max) const {
@@ -83,4 +229,3 @@ bool Territory::isEmpty() const {
 const optional<Position>& Territory::getCentralPoint() const {
   return centralPoint;
 }
-
@@ -3,6 +3,10 @@
 #include "util.h"
 #include "position.h"
 
+/** The tiles claimed by a collective and the rings of walkable tiles around them. Both are kept in
+    per-level tables. Claiming or unclaiming a tile only re-propagates the part of the rings that
+    depended on it, so changes in walkability that don't come with a claim aren't noticed until
+    a nearby tile is claimed or unclaimed.*/
 class Territory {
   public:
   void insert(Position);
@@ -14,6 +18,8 @@ class Territory {
   const vector<Position>& getExtended(int min, int max) const;
   const vector<Position>& getExtended(int max) const;
   const vector<Position>& getStandardExtended() const;
+  /** Same as getStandardExtended().contains(), but doesn't build the list.*/
+  bool isStandardExtended(Position) const;
   bool isEmpty() const;
   const optional<Position>& getCentralPoint() const;
 
@@ -23,9 +29,28 @@ class Territory {
   private:
   void clearCache();
   vector<Position> calculateExtended(int minRadius, int maxRadius) const;
-  set<Position> SERIAL(allSquares);
+  struct LevelTiles {
+    LevelTiles(Rectangle bounds);
+    Table<int> territoryIndex;
+    // The distance, plus a flag that tells if the tile is in the reached list.
+    Table<std::uint8_t> distance;
+  };
+  const LevelTiles* getTiles(Position) const;
+  LevelTiles& getOrInitTiles(Position);
+  int getDistance(Position) const;
+  void setDistance(Position, int);
+  bool canExtendTo(Position) const;
+  void propagate(vector<vector<Position>>& buckets);
+  void updateTables() const;
+  void rebuildTables();
+  void compactReached();
   vector<Position> SERIAL(allSquaresVec);
   optional<Position> SERIAL(centralPoint);
+  map<LevelId, LevelTiles> levels;
+  // All tiles with a distance, and some that lost it since the last compactReached().
+  vector<Position> reached;
+  int numReached = 0;
+  bool tablesValid = true;
   mutable map<pair<int, int>, vector<Position>> extendedCache;
   mutable map<int, vector<Position>> extendedCache2;
 };
@@ -32,6 +32,24 @@
 #include "container_range.h"
 #include "serialization.h"
 #include "text_serialization.h"
+#include "sprite_batch.h"
+#include "light_map.h"
+#include "event_listener.h"
+#include "poison_gas.h"
+#include "dirty_regions.h"
+#include "tile_atlas_cache.h"
+#include "parallel_gzstream.h"
+#include "gzstream.h"
+#include "territory.h"
+#include "position_set.h"
+#include "model.h"
+#include "level.h"
+#include "level_builder.h"
+#include "position.h"
+#include "movement_type.h"
+#include "furniture.h"
+#include "furniture_factory.h"
+#include "furniture_type.h"
 
 class Test {
   public:
@@ -635,6 +653,38 @@ class Test {
     CHECK(equipment.getItemsOwnedBy(human1.get()).size() == 0);
   }
 
+  void testMinionEquipmentAutoAssignBatch() {
+    PItem sword1 = ItemFactory::fromId(ItemId::SWORD);
+    PItem sword2 = ItemFactory::fromId(ItemId::SWORD);
+    sword1->addModifier(ModifierType::DAMAGE, 12);
+    PItem bow = ItemFactory::fromId(ItemId::BOW);
+    vector<PItem> arrows = ItemFactory::fromId(ItemId::ARROW, 10);
+    PCreature human1 = CreatureFactory::fromId(CreatureId::BANDIT, TribeId::getBandit());
+    PCreature human2 = CreatureFactory::fromId(CreatureId::BANDIT, TribeId::getBandit());
+    PCreature human3 = CreatureFactory::fromId(CreatureId::BANDIT, TribeId::getBandit());
+    MinionEquipment equipment;
+    equipment.autoAssign(human1.get(), {bow.get()});
+    vector<WItem> items = concat<WItem>({sword2.get(), sword1.get()}, getWeakPointers(arrows));
+    equipment.autoAssign({human1.get(), human2.get(), human3.get()}, items);
+    CHECK(equipment.isOwner(sword1.get(), human1.get()));
+    CHECK(equipment.isOwner(sword2.get(), human2.get()));
+    CHECK(equipment.getItemsOwnedBy(human1.get()).size() == 12);
+    CHECK(equipment.getItemsOwnedBy(human2.get()).size() == 1);
+    CHECK(equipment.getItemsOwnedBy(human3.get()).empty());
+    // human2's weapon slot is full and sword3 is no better than sword2, so the scan stops there. sword4 is
+    // out of order on purpose, it would be taken if the scan went on.
+    PItem sword3 = ItemFactory::fromId(ItemId::SWORD);
+    PItem sword4 = ItemFactory::fromId(ItemId::SWORD);
+    sword4->addModifier(ModifierType::DAMAGE, 20);
+    vector<WItem> bucket {sword3.get(), sword4.get()};
+    auto slots = equipment.getEquippedSlots(human2.get());
+    equipment.assignFirstNeeded(human2.get(), bucket, slots);
+    CHECK(bucket.size() == 2);
+    CHECK(!equipment.getOwner(sword4.get()));
+    equipment.autoAssign(vector<WConstCreature>{human2.get()}, bucket);
+    CHECK(equipment.isOwner(sword4.get(), human2.get()));
+  }
+
   void testMinionEquipmentLocking() {
     PItem sword1 = ItemFactory::fromId(ItemId::SWORD);
     PItem sword2 = ItemFactory::fromId(ItemId::SWORD);
@@ -683,6 +733,130 @@ class Test {
     CHECK(equipment.getItemsOwnedBy(human.get()).size() == items.size());
   }
 
+  void testTerritory() {
+    auto model = Model::create();
+    PLevel levelOwner = LevelBuilder(Random, 60, 60, "test", false)
+        .build(model.get(), LevelMaker::emptyLevel(Random).get(), Random.getLL());
+    WLevel level = levelOwner.get();
+    for (int i : Range(300)) {
+      Position pos(Vec2(Random.get(60), Random.get(60)), level);
+      if (pos.canEnterEmpty({MovementTrait::WALK}))
+        pos.addFurniture(FurnitureFactory::get(FurnitureType::MUD_WALL, TribeId::getMonster()));
+    }
+    Territory territory;
+    // Compares the territory with walking distances computed from scratch, the same way as before the tables
+    // were added.
+    auto check = [&] {
+      Table<int> distances(level->getBounds(), 0);
+      vector<Position> queue;
+      for (Position pos : territory.getAll()) {
+        distances[pos.getCoord()] = 1;
+        queue.push_back(pos);
+      }
+      for (int i = 0; i < queue.size(); ++i) {
+        int dist = distances[queue[i].getCoord()];
+        if (dist < 20)
+          for (Position v : queue[i].neighbors8())
+            if (v.getCoord().inRectangle(level->getBounds()) && distances[v.getCoord()] == 0 &&
+                v.canEnterEmpty({MovementTrait::WALK})) {
+              distances[v.getCoord()] = dist + 1;
+              queue.push_back(v);
+            }
+      }
+      vector<Position> standard;
+      vector<Position> extended;
+      for (Vec2 v : level->getBounds()) {
+        Position pos(v, level);
+        int dist = distances[v];
+        CHECK(territory.contains(pos) == (dist == 1));
+        CHECK(territory.isStandardExtended(pos) == (dist >= 2 && dist <= 10));
+        if (dist >= 2 && dist <= 10)
+          standard.push_back(pos);
+        if (dist >= 1 && dist <= 15)
+          extended.push_back(pos);
+      }
+      auto sorted = [](vector<Position> v) {
+        sort(v.begin(), v.end());
+        return v;
+      };
+      CHECK(sorted(territory.getStandardExtended()) == sorted(standard));
+      CHECK(sorted(territory.getExtended(15)) == sorted(extended));
+    };
+    // Claims are kept near the middle, so that some rings reach the level edge and some don't. Emptying the
+    // territory makes the unreached tiles pile up, so the tile list gets compacted.
+    for (int round : Range(3)) {
+      for (int i : Range(150)) {
+        if (territory.getAll().size() < 10 || Random.roll(2))
+          territory.insert(Position(Vec2(Random.get(20, 40), Random.get(20, 40)), level));
+        else
+          territory.remove(Random.choose(territory.getAll()));
+        check();
+      }
+      while (!territory.isEmpty()) {
+        territory.remove(Random.choose(territory.getAll()));
+        check();
+      }
+    }
+  }
+
+  void testPositionSet() {
+    auto model = Model::create();
+    PLevel level = LevelBuilder(Random, 20, 20, "test", false)
+        .build(model.get(), LevelMaker::emptyLevel(Random).get(), Random.getLL());
+    auto pos = [&](int x, int y) { return Position(Vec2(x, y), level.get()); };
+    PositionSet set;
+    for (int i : Range(10))
+      set.insert(pos(i, 0));
+    set.insert(pos(3, 0));
+    CHECK(set.size() == 10);
+    set.erase(pos(3, 0));
+    set.erase(pos(3, 0));
+    set.erase(pos(15, 15));
+    CHECK(set.size() == 9);
+    CHECK(!set.contains(pos(3, 0)));
+    CHECK(!asVector<Position>(set).contains(pos(3, 0)));
+    // Still listed, so it's not added again at the end.
+    set.insert(pos(3, 0));
+    CHECK(asVector<Position>(set) == pos(0, 0).getRectangle(Rectangle(10, 1)));
+    // Erasing doesn't move the elements until most of them are gone, so a nested iteration doesn't
+    // invalidate the outer one.
+    set.erase(pos(5, 0));
+    int numPairs = 0;
+    for (auto& p1 : set)
+      for (auto& p2 : set)
+        if (p1 != p2) {
+          CHECK(p1 != pos(5, 0) && p2 != pos(5, 0));
+          ++numPairs;
+        }
+    CHECK(numPairs == 9 * 8);
+    for (int i : Range(1, 8))
+      set.erase(pos(i, 0));
+    CHECK(asVector<Position>(set) == makeVec(pos(0, 0), pos(8, 0), pos(9, 0)));
+    set.insert(pos(5, 0));
+    CHECK(asVector<Position>(set) == makeVec(pos(0, 0), pos(8, 0), pos(9, 0), pos(5, 0)));
+    set.erase(pos(8, 0));
+    std::stringstream stream;
+    {
+      OutputArchive output(stream);
+      output << model << level << set;
+      output.flush();
+    }
+    InputArchive input(stream);
+    PModel model2;
+    PLevel level2;
+    PositionSet set2;
+    input >> model2 >> level2 >> set2;
+    // The bitmaps are built on first use, after the levels are loaded.
+    auto pos2 = [&](int x, int y) { return Position(Vec2(x, y), level2.get()); };
+    CHECK(set2.size() == 3);
+    CHECK(set2.contains(pos2(9, 0)));
+    CHECK(!set2.contains(pos2(8, 0)));
+    CHECK(asVector<Position>(set2) == makeVec(pos2(0, 0), pos2(9, 0), pos2(5, 0)));
+    set2.insert(pos2(8, 0));
+    set2.erase(pos2(0, 0));
+    CHECK(asVector<Position>(set2) == makeVec(pos2(9, 0), pos2(5, 0), pos2(8, 0)));
+  }
+
   void testContainerRange() {
     vector<string> v { "abc", "def", "ghi" };
     int i = 0;
@@ -841,6 +1015,262 @@ class Test {
     CHECK(a == b);
   }
 
+  struct Tmp789 {
+    shared_ptr<Tmp123> SERIAL(a);
+    shared_ptr<Tmp123> SERIAL(b);
+    weak_ptr<Tmp123> SERIAL(c);
+    std::vector<int> SERIAL(d);
+    vector<shared_ptr<Tmp456>> SERIAL(e);
+    SERIALIZE_ALL(a, b, c, d, e)
+  };
+
+  void testFlatArchive() {
+    Tmp789 a;
+    a.a = make_shared<Tmp123>(Tmp123{1, 'x', 2.5, "foo", 1.5});
+    a.b = a.a;
+    a.c = a.a;
+    for (int i : Range(100000))
+      a.d.push_back(i * 7);
+    for (int i : Range(5000))
+      a.e.push_back(make_shared<Tmp456>(Tmp456{'a', Tmp123{i, 'y', 0.5, toString(i), 2.5}, 'b', 'c', 'd'}));
+    a.e.push_back(a.e[17]);
+    std::stringstream stream;
+    {
+      OutputArchive output(stream);
+      output << a << a.e[5];
+    }
+    InputArchive input(stream);
+    Tmp789 b;
+    shared_ptr<Tmp456> e5;
+    input >> b >> e5;
+    CHECK(*b.a == *a.a);
+    CHECK(b.a == b.b);
+    CHECK(b.c.lock() == b.a);
+    CHECK(b.d == a.d);
+    CHECKEQ(b.e.size(), a.e.size());
+    for (int i : Range(5000))
+      CHECK(*b.e[i] == *a.e[i]);
+    CHECK(b.e.back() == b.e[17]);
+    CHECK(e5 == b.e[5]);
+  }
+
+  void testLightMap() {
+    Rectangle bounds(10, 10);
+    bool wall = false;
+    // A wall at x == 6 blocks everything behind it.
+    auto visibleTiles = [&](Vec2 pos) {
+      vector<Vec2> ret;
+      for (Vec2 v : bounds)
+        if (!wall || (v.x < 6) == (pos.x < 6) || v.x == 6)
+          ret.push_back(v);
+      return ret;
+    };
+    int numChanged = 0;
+    LightMap lightMap(bounds, visibleTiles, [&](Vec2) { ++numChanged; });
+    lightMap.addLight(Vec2(5, 5), 3, 1);
+    CHECK(lightMap.getLight(Vec2(5, 5)) == 1);
+    CHECK(lightMap.getLight(Vec2(7, 5)) > 0);
+    CHECK(lightMap.getLight(Vec2(9, 5)) == 0);
+    CHECK(numChanged > 0);
+    wall = true;
+    auto sources = lightMap.removeSourcesNear(Vec2(6, 5));
+    CHECK(sources.size() == 1);
+    lightMap.restoreSources(sources);
+    CHECK(lightMap.getLight(Vec2(7, 5)) == 0);
+    CHECK(lightMap.getLight(Vec2(6, 5)) > 0);
+    CHECK(lightMap.removeSourcesNear(Vec2(0, 9)).empty());
+    lightMap.addDarkness(Vec2(4, 5), 2, 1);
+    CHECK(lightMap.getLightCap(Vec2(4, 5)) == 0);
+    lightMap.addDarkness(Vec2(4, 5), 2, -1);
+    lightMap.addLight(Vec2(5, 5), 3, -1);
+    for (Vec2 v : bounds) {
+      CHECK(lightMap.getLight(v) == 0);
+      CHECK(lightMap.getLightCap(v) == 1);
+    }
+  }
+
+  struct CountingListener : public OwnedObject<CountingListener> {
+    void onEvent(const GameEvent& e) {
+      ids.push_back(e.getId());
+    }
+    vector<EventId> ids;
+  };
+
+  void testPoisonGas() {
+    Rectangle bounds(40, 20);
+    PoisonGas gas(bounds);
+    for (int y : Range(20))
+      gas.setTransparent(Vec2(10, y), false);
+    gas.addAmount(Vec2(5, 5), 1);
+    gas.addAmount(Vec2(10, 5), 1);
+    CHECK(gas.getAmount(Vec2(10, 5)) == 0);
+    set<Vec2> changed;
+    gas.tick([&](Vec2 pos, double) { changed.insert(pos); });
+    CHECK(changed.size() == 9);
+    CHECK(gas.getAmount(Vec2(5, 5)) < 1);
+    CHECK(gas.getAmount(Vec2(6, 5)) == gas.getAmount(Vec2(4, 5)));
+    CHECK(gas.getAmount(Vec2(6, 5)) > gas.getAmount(Vec2(6, 6)));
+    for (int i : Range(20))
+      gas.tick([](Vec2, double) {});
+    double total = 0;
+    for (Vec2 v : bounds) {
+      if (v.x >= 10)
+        CHECK(gas.getAmount(v) == 0);
+      total += gas.getAmount(v);
+    }
+    CHECK(total > 0 && total < 1);
+    int numTicks = 0;
+    while (total > 0) {
+      CHECK(++numTicks < 1000);
+      gas.tick([](Vec2, double) {});
+      total = 0;
+      for (Vec2 v : bounds)
+        total += gas.getAmount(v);
+    }
+    changed.clear();
+    gas.tick([&](Vec2 pos, double) { changed.insert(pos); });
+    CHECK(changed.empty());
+  }
+
+  void testDirtyRegions() {
+    DirtyRegions dirty(Rectangle(512, 512), 32);
+    auto getNumTexels = [&] {
+      int ret = 0;
+      for (auto& rect : dirty.pop())
+        ret += rect.area();
+      return ret;
+    };
+    CHECK(dirty.isEmpty());
+    CHECK(getNumTexels() == 0);
+    dirty.add(Vec2(5, 5));
+    dirty.add(Vec2(6, 5));
+    CHECK(!dirty.isEmpty());
+    CHECK(getNumTexels() == 32 * 32);
+    CHECK(dirty.isEmpty());
+    dirty.add(Vec2(40, 5));
+    dirty.add(Vec2(70, 5));
+    dirty.add(Vec2(70, 300));
+    auto regions = dirty.pop();
+    CHECK(regions.size() == 2);
+    CHECK(regions[0] == Rectangle(32, 0, 96, 32));
+    dirty.addAll();
+    CHECK(getNumTexels() == 512 * 512);
+    DirtyRegions uneven(Rectangle(50, 40), 32);
+    uneven.add(Vec2(49, 39));
+    CHECK(uneven.pop() == vector<Rectangle>({Rectangle(32, 32, 50, 40)}));
+  }
+
+  void testTileAtlasCache() {
+    auto path = FilePath::fromFullPath("tile_atlas_cache_test.tmp");
+    TileAtlasCache::Atlas atlas {Vec2(4, 2), {"floor", "wall"}, {1, 2, 3, 4, 5, 6, 7, 0xffffffff}};
+    TileAtlasCache::save(path, 123, atlas);
+    CHECK(!TileAtlasCache::load(path, 124));
+    auto loaded = TileAtlasCache::load(path, 123);
+    CHECK(!!loaded);
+    CHECK(loaded->size == atlas.size);
+    CHECK(loaded->names == atlas.names);
+    CHECK(loaded->pixels == atlas.pixels);
+    std::remove(path.getPath());
+    CHECK(!TileAtlasCache::load(path, 123));
+  }
+
+  void testParallelGzStream() {
+    string path = "parallel_gzstream_test.tmp";
+    // Several blocks, with a chunk that repeats across block boundaries, so that the blocks depend
+    // on their dictionaries.
+    RandomGen random;
+    random.init(123);
+    string chunk;
+    for (int i : Range(20000))
+      chunk += char(random.get(256));
+    string data;
+    while (data.size() < 3500000) {
+      data += chunk;
+      data += toString(data.size());
+    }
+    {
+      ParallelGzOutput output(path);
+      output.write(data.data(), data.size());
+      output.close();
+    }
+    string compressed;
+    {
+      std::ifstream file(path, std::ios::binary);
+      compressed.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    CHECK(compressed.size() < data.size() / 5);
+    // A plain inflate checks the joined stream, and the crc and length in the trailer.
+    string inflated(data.size() + 1, 0);
+    z_stream stream {};
+    CHECK(inflateInit2(&stream, 16 + MAX_WBITS) == Z_OK);
+    stream.next_in = (Bytef*) compressed.data();
+    stream.avail_in = compressed.size();
+    stream.next_out = (Bytef*) inflated.data();
+    stream.avail_out = inflated.size();
+    CHECK(inflate(&stream, Z_FINISH) == Z_STREAM_END);
+    CHECK(stream.total_out == data.size());
+    inflateEnd(&stream);
+    inflated.resize(data.size());
+    CHECK(inflated == data);
+    auto readAll = [&](std::istream& input) {
+      return string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    };
+    {
+      PrefetchGzInput input(path);
+      CHECK(readAll(input) == data);
+    }
+    {
+      igzstream input(path.c_str());
+      CHECK(readAll(input) == data);
+    }
+    std::remove(path.c_str());
+  }
+
+  void testEventGenerator() {
+    EventGenerator generator;
+    auto l1 = makeOwner<CountingListener>();
+    auto l2 = makeOwner<CountingListener>();
+    auto l3 = makeOwner<CountingListener>();
+    generator.addListener(l1.get(), {EventId::TECHBOOK_READ}, false);
+    generator.addListener(l2.get(), {EventId::TECHBOOK_READ, EventId::CONQUERED_ENEMY}, true);
+    auto id3 = generator.addListener(l3.get(), {EventId::CONQUERED_ENEMY}, false);
+    generator.addEvent({EventId::CONQUERED_ENEMY, WCollective(nullptr)});
+    CHECK(l1->ids.empty());
+    CHECK(l2->ids.size() == 1);
+    CHECK(l3->ids.size() == 1);
+    generator.startBatch();
+    generator.addEvent({EventId::TECHBOOK_READ, (Technology*) nullptr});
+    generator.addEvent({EventId::CONQUERED_ENEMY, WCollective(nullptr)});
+    CHECK(l1->ids.size() == 1);
+    CHECK(l2->ids.size() == 1);
+    CHECK(l3->ids.size() == 2);
+    generator.removeListener(id3);
+    generator.flushBatch();
+    CHECK(l2->ids == vector<EventId>({EventId::CONQUERED_ENEMY, EventId::TECHBOOK_READ, EventId::CONQUERED_ENEMY}));
+    generator.addEvent({EventId::CONQUERED_ENEMY, WCollective(nullptr)});
+    CHECK(l3->ids.size() == 2);
+  }
+
+  void testSpriteBatch() {
+    SpriteBatch batch;
+    SpriteBatch::Vertex quad[4] {};
+    for (int i : Range(10))
+      batch.addQuad(1, none, quad);
+    CHECK(batch.getNumDrawCalls() == 1);
+    CHECK(batch.getVertices().size() == 40);
+    for (int i : Range(10))
+      batch.addQuad(i % 2 + 2, none, quad);
+    CHECK(batch.getNumDrawCalls() == 11);
+    batch.addCustom(none, []{});
+    batch.addQuad(3, none, quad);
+    CHECK(batch.getNumDrawCalls() == 13);
+    batch.addQuad(3, Rectangle(0, 0, 10, 10), quad);
+    batch.addQuad(3, Rectangle(0, 0, 10, 10), quad);
+    CHECK(batch.getNumDrawCalls() == 14);
+    batch.clear();
+    CHECK(batch.getNumDrawCalls() == 0);
+    CHECK(batch.getVertices().empty());
+  }
 };
 
 void testAll() {
@@ -880,8 +1310,11 @@ void testAll() {
   Test().testMinionEquipmentUpdateItems();
   Test().testMinionEquipmentUpdateOwners();
   Test().testMinionEquipmentAutoAssign();
+  Test().testMinionEquipmentAutoAssignBatch();
   Test().testMinionEquipmentLocking();
   Test().testMinionEquipment123();
+  Test().testTerritory();
+  Test().testPositionSet();
   Test().testContainerRange();
   Test().testContainerRangeMap();
   Test().testContainerRangeErase();
@@ -892,5 +1325,13 @@ void testAll() {
   Test().testCacheTemplate();
   Test().testCacheTemplate2();
   Test().testTextSerialization();
+  Test().testFlatArchive();
+  Test().testSpriteBatch();
+  Test().testLightMap();
+  Test().testEventGenerator();
+  Test().testPoisonGas();
+  Test().testDirtyRegions();
+  Test().testTileAtlasCache();
+  Test().testParallelGzStream();
   INFO << "-----===== OK =====-----";
 }
@@ -0,0 +1,88 @@
+#include "stdafx.h"
+#include "tile_atlas_cache.h"
+
+static const char magic[] = "KRLATLAS";
+static const std::uint32_t cacheVersion = 1;
+
+std::uint64_t TileAtlasCache::getKey(const vector<FilePath>& files, Vec2 tileSize, int setWidth) {
+  // FNV-1a, so that the key doesn't depend on the standard library's hash.
+  std::uint64_t ret = 14695981039346656037ull;
+  auto add = [&ret](const string& s) {
+    for (char c : s) {
+      ret ^= (unsigned char) c;
+      ret *= 1099511628211ull;
+    }
+  };
+  vector<string> entries;
+  for (auto& file : files)
+    entries.push_back(file.getFileName() + ":"_s + toString((long long) file.getModificationTime()));
+  std::sort(entries.begin(), entries.end());
+  for (auto& entry : entries)
+    add(entry + "\n");
+  add(toString(tileSize) + " " + toString(setWidth));
+  return ret;
+}
+
+template <typename T>
+static void writeValue(std::ofstream& out, const T& value) {
+  out.write((const char*) &value, sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::ifstream& in, T& value) {
+  return !!in.read((char*) &value, sizeof(value));
+}
+
+optional<TileAtlasCache::Atlas> TileAtlasCache::load(const FilePath& path, std::uint64_t key) {
+  std::ifstream in(path.getPath(), std::ios::binary);
+  char header[sizeof(magic)];
+  std::uint32_t version;
+  std::uint64_t fileKey;
+  std::int32_t width, height, numNames;
+  if (!in.read(header, sizeof(header)) || string(header, sizeof(header)) != string(magic, sizeof(magic)) ||
+      !readValue(in, version) || version != cacheVersion || !readValue(in, fileKey) || fileKey != key ||
+      !readValue(in, width) || !readValue(in, height) || !readValue(in, numNames) ||
+      width < 0 || height < 0 || numNames < 0)
+    return none;
+  Atlas ret;
+  ret.size = Vec2(width, height);
+  for (int i : Range(numNames)) {
+    std::uint32_t length;
+    if (!readValue(in, length) || length > 1000)
+      return none;
+    string name(length, ' ');
+    if (!in.read(&name[0], length))
+      return none;
+    ret.names.push_back(name);
+  }
+  ret.pixels.resize(width * height);
+  if (!in.read((char*) ret.pixels.data(), ret.pixels.size() * sizeof(std::uint32_t)))
+    return none;
+  return ret;
+}
+
+void TileAtlasCache::save(const FilePath& path, std::uint64_t key, const Atlas& atlas) {
+  CHECK(atlas.pixels.size() == atlas.size.x * atlas.size.y);
+  // Written to a temporary file first, so that an interrupted write never leaves a broken cache.
+  string tmpPath = path.getPath() + ".tmp"_s;
+  {
+    std::ofstream out(tmpPath, std::ios::binary);
+    out.write(magic, sizeof(magic));
+    writeValue(out, cacheVersion);
+    writeValue(out, key);
+    writeValue(out, std::int32_t(atlas.size.x));
+    writeValue(out, std::int32_t(atlas.size.y));
+    writeValue(out, std::int32_t(atlas.names.size()));
+    for (auto& name : atlas.names) {
+      writeValue(out, std::uint32_t(name.size()));
+      out.write(name.data(), name.size());
+    }
+    out.write((const char*) atlas.pixels.data(), atlas.pixels.size() * sizeof(std::uint32_t));
+    if (!out) {
+      INFO << "Failed to write tile cache " << path;
+      return;
+    }
+  }
+  std::remove(path.getPath());
+  std::rename(tmpPath.c_str(), path.getPath());
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "util.h"
+#include "file_path.h"
+
+/** Uncompressed tile atlas saved to disk, so that the tile images don't have to be decoded on every start.
+    The cache is valid only for the same set of file names and modification times.*/
+class TileAtlasCache {
+  public:
+  struct Atlas {
+    Vec2 size;
+    // Tile names in the order in which they are placed in the atlas, row by row.
+    vector<string> names;
+    std::vector<std::uint32_t> pixels;
+  };
+
+  static std::uint64_t getKey(const vector<FilePath>& files, Vec2 tileSize, int setWidth);
+  static optional<Atlas> load(const FilePath&, std::uint64_t key);
+  static void save(const FilePath&, std::uint64_t key, const Atlas&);
+};
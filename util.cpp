@@ -87,7 +87,7 @@ double RandomGen::getDouble(double a, double b) {
   return uniform_real_distribution<double>(a, b)(generator);
 }
 
-RandomGen Random;
+thread_local RandomGen Random;
 
 template string toString<int>(const int&);
 template string toString<unsigned int>(const unsigned int&);
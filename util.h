@@ -585,7 +585,8 @@ class RandomGen {
   }
 };
 
-extern RandomGen Random;
+// Each thread has its own generator. Threads that need randomness should seed it from the thread that started them.
+extern thread_local RandomGen Random;
 
 inline std::ostream& operator <<(std::ostream& d, Rectangle rect) {
   return d << "(" << rect.left() << "," << rect.top() << ") (" << rect.right() << "," << rect.bottom() << ")";
@@ -48,7 +48,8 @@ VillageControl::VillageControl(Private, WCollective col, optional<VillageBehavio
 
 PVillageControl VillageControl::create(WCollective col, optional<VillageBehaviour> v) {
   auto ret = makeOwner<VillageControl>(Private{}, col, v);
-  ret->subscribeTo(col->getModel());
+  // Stolen items are only counted, so they can wait until the thief's move is finished.
+  ret->subscribeTo(col->getModel(), {EventId::PICKED_UP}, true);
   return ret;
 }
 
@@ -27,7 +27,7 @@ void Zones::eraseZones(Position pos) {
     eraseZone(pos, id);
 }
 
-const set<Position>& Zones::getPositions(ZoneId id) const {
+const PositionSet& Zones::getPositions(ZoneId id) const {
   return zones[id];
 }
 
@@ -51,7 +51,7 @@ void Zones::setHighlights(Position pos, ViewIndex& index) const {
 }
 
 void Zones::tick() {
-  for (auto pos : copyOf(zones[ZoneId::FETCH_ITEMS]))
+  for (auto pos : asVector<Position>(zones[ZoneId::FETCH_ITEMS]))
     if (pos.getItems().empty())
       eraseZone(pos, ZoneId::FETCH_ITEMS);
 }
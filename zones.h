@@ -1,6 +1,7 @@
 #pragma once
 
 #include "util.h"
+#include "position_set.h"
 
 RICH_ENUM(ZoneId,
   FETCH_ITEMS,
@@ -9,7 +10,6 @@ RICH_ENUM(ZoneId,
   STORAGE_RESOURCES
 );
 
-class Position;
 class ViewIndex;
 
 class Zones {
@@ -19,7 +19,7 @@ class Zones {
   void setZone(Position, ZoneId);
   void eraseZone(Position, ZoneId);
   void eraseZones(Position);
-  const set<Position>& getPositions(ZoneId) const;
+  const PositionSet& getPositions(ZoneId) const;
   void setHighlights(Position, ViewIndex&) const;
   void tick();
 
@@ -27,5 +27,5 @@ class Zones {
   void serialize(Archive& ar, const unsigned int version);
 
   private:
-  EnumMap<ZoneId, set<Position>> SERIAL(zones);
+  EnumMap<ZoneId, PositionSet> SERIAL(zones);
 };